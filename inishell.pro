@@ -25,7 +25,7 @@ CONFIG += release
 
 message("Building from $$_PRO_FILE_ ...")
 
-QT += core gui widgets xml xmlpatterns
+QT += core gui widgets xml xmlpatterns concurrent
 
 CONFIG += c++11
 #CONFIG += static
@@ -67,6 +67,7 @@ QMAKE_BUNDLE_DATA += applicationsXML
 SOURCES += \
     src/gui/AboutWindow.cc \
     src/gui/ApplicationsView.cc \
+    src/gui/IconCache.cc \
     src/gui/IniFolderView.cc \
     src/gui/Logger.cc \
     src/gui/MainPanel.cc \
@@ -81,6 +82,7 @@ SOURCES += \
     src/gui_elements/Checklist.cc \
     src/gui_elements/Choice.cc \
     src/gui_elements/Datepicker.cc \
+    src/gui_elements/DocumentModel.cc \
     src/gui_elements/Dropdown.cc \
     src/gui_elements/FilePath.cc \
     src/gui_elements/GridPanel.cc \
@@ -88,21 +90,27 @@ SOURCES += \
     src/gui_elements/gui_elements.cc \
     src/gui_elements/Helptext.cc \
     src/gui_elements/HorizontalPanel.cc \
+    src/gui_elements/ItemTemplate.cc \
+    src/gui_elements/KeyTemplateTrie.cc \
     src/gui_elements/Label.cc \
     src/gui_elements/Number.cc \
     src/gui_elements/Replicator.cc \
     src/gui_elements/Selector.cc \
     src/gui_elements/Spacer.cc \
     src/gui_elements/Textfield.cc \
+    src/gui_elements/ValidationScheduler.cc \
+    src/main/AppScanner.cc \
     src/main/colors.cc \
     src/main/common.cc \
     src/main/dimensions.cc \
     src/main/Error.cc \
     src/main/INIParser.cc \
     src/main/expressions.cc \
+    src/main/FileStatCache.cc \
     src/main/inishell.cc \
     src/main/main.cc \
     src/main/os.cc \
+    src/main/SchemaValidator.cc \
     src/main/settings.cc \
     src/main/XMLReader.cc \
     lib/tinyexpr.c
@@ -110,6 +118,7 @@ SOURCES += \
 HEADERS += \
     src/gui/AboutWindow.h \
     src/gui/ApplicationsView.h \
+    src/gui/IconCache.h \
     src/gui/IniFolderView.h \
     src/gui/Logger.h \
     src/gui/MainPanel.h \
@@ -124,6 +133,7 @@ HEADERS += \
     src/gui_elements/Checklist.h \
     src/gui_elements/Choice.h \
     src/gui_elements/Datepicker.h \
+    src/gui_elements/DocumentModel.h \
     src/gui_elements/Dropdown.h \
     src/gui_elements/FilePath.h \
     src/gui_elements/gui_elements.h \
@@ -131,12 +141,16 @@ HEADERS += \
     src/gui_elements/Group.h \
     src/gui_elements/Helptext.h \
     src/gui_elements/HorizontalPanel.h \
+    src/gui_elements/ItemTemplate.h \
+    src/gui_elements/KeyTemplateTrie.h \
     src/gui_elements/Label.h \
     src/gui_elements/Number.h \
     src/gui_elements/Replicator.h \
     src/gui_elements/Selector.h \
     src/gui_elements/Spacer.h \
     src/gui_elements/Textfield.h \
+    src/gui_elements/ValidationScheduler.h \
+    src/main/AppScanner.h \
     src/main/XMLReader.h \
     src/main/colors.h \
     src/main/common.h \
@@ -145,8 +159,10 @@ HEADERS += \
     src/main/Error.h \
     src/main/INIParser.h \
     src/main/expressions.h \
+    src/main/FileStatCache.h \
     src/main/inishell.h \
     src/main/os.h \
+    src/main/SchemaValidator.h \
     src/main/settings.h \
     lib/tinyexpr.h
 
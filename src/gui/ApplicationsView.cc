@@ -28,26 +28,37 @@
 #include <QAction>
 #include <QDesktopServices>
 #include <QFileDialog>
-#include <QFileIconProvider>
 #include <QFileInfo>
-#include <QRegularExpression>
+#include <QScrollBar>
+#include <QTimer>
 #include <QVBoxLayout>
 
 #include <utility>
 
+static constexpr int role_directory = Qt::UserRole + 1; //search directory an item belongs to
+static constexpr int role_dir_index = Qt::UserRole + 2; //position of the directory in the search list
+static constexpr int role_empty_info = Qt::UserRole + 3; //info text for an empty list
+static constexpr int role_icon_file = Qt::UserRole + 4; //icon that is still to be loaded
+
 /**
  * @class ApplicationsView
  * @brief Constructor for an ApplicationsView.
  * @param[in] tag_name A human readable name for this panel which is used to e. g. store settings.
  * It could look like "Applications" or "Simulations".
+ * @param[in] icon_cache Loads the applications' icons in the background.
  * @param[in] parent This panel's parent window.
  */
-ApplicationsView::ApplicationsView(QString tag_name, QWidget *parent)
-    : QWidget(parent), tag_name_(std::move(tag_name))
+ApplicationsView::ApplicationsView(QString tag_name, IconCache *icon_cache, QWidget *parent)
+    : QWidget(parent), icon_cache_(icon_cache), tag_name_(std::move(tag_name))
 {
 	application_list_ = new QListWidget;
 	application_list_->setWordWrap(true); //for the path hints
 
+	/* icons are only loaded for items that are visible */
+	connect(icon_cache_, &IconCache::iconLoaded, this, &ApplicationsView::onIconLoaded);
+	connect(application_list_->verticalScrollBar(), &QScrollBar::valueChanged, this,
+	    &ApplicationsView::loadVisibleIcons);
+
 	/* connect the context menu and mouse clicks */
 	application_list_->setContextMenuPolicy(Qt::CustomContextMenu);
 	createContextMenu();
@@ -60,39 +71,87 @@ ApplicationsView::ApplicationsView(QString tag_name, QWidget *parent)
 }
 
 /**
- * @brief Add an application/simulation XML file to the file list.
- * @param[in] file The file to display in the application list. It is already checked that this
- * should be an INIshell file.
- * @param[in] match_inishell The regular expression that was used to validate the file. It contains
- * other info which we don't have to extract again.
+ * @brief Create a list item for an application/simulation XML file.
+ * @param[in] header The file's header info. It is already checked that this is an INIshell file.
+ * @return The new list item.
  */
-void ApplicationsView::addApplication(const QFile &file, const QRegularExpressionMatch &match_inishell)
+QListWidgetItem * ApplicationsView::createApplication(const AppHeader &header) const
 {
-	static const int idx_name = 2;
-	static const int idx_icon = 4;
 	auto *app = new QListWidgetItem;
-	app->setText(match_inishell.captured(idx_name)); //user given name
-
-	//check if a specified icon is found in the same location:
-	const QString icon_file(QFileInfo( file ).path() + "/" + match_inishell.captured(idx_icon));
-	if (QFileInfo( icon_file ).isFile()) {
-		const QIcon item_icon(icon_file);
-		app->setIcon(item_icon);
-	} else { //TODO: load nicer, specialized, icons in this case
-		QFileIconProvider icon_provider;
-		const QIcon item_icon( icon_provider.icon(QFileIconProvider::File) );
-		app->setIcon(item_icon);
+	app->setText(header.name); //user given name
+
+	//TODO: load nicer, specialized, icons if none is given
+	app->setIcon(IconCache::getDefaultIcon()); //until the real icon is loaded
+	if (!header.icon.isEmpty()) //icon in the same location, will be loaded when the item is shown
+		app->setData(role_icon_file, QFileInfo( header.file_name ).path() + "/" + header.icon);
+	app->setData(Qt::UserRole, header.file_name); //store the full file path
+	app->setToolTip(header.file_name); //(stored twice in case the ToolTip changes at some point)
+	return app;
+}
+
+/**
+ * @brief Display the applications/simulations found in a search directory.
+ * @details Items previously shown for this directory are replaced, so that a single directory
+ * can be updated without rebuilding the whole list. The directory's path is displayed as
+ * separator if it contains valid XMLs.
+ * Directories are sorted by the order of the search directories they were found in, and
+ * subdirectories by name.
+ * @param[in] app_dir The directory with all XML files found in it.
+ * @param[in] type Only show files of this type ("application" or "simulation").
+ */
+void ApplicationsView::setDirectory(const AppDirectory &app_dir, const QString &type)
+{
+	removeDirectory(app_dir.directory);
+	const int dir_index = app_dir.root_index;
+
+	//insert before the first directory that comes later in the search order:
+	int row = application_list_->count();
+	for (int ii = 0; ii < application_list_->count(); ++ii) {
+		const QVariant item_index( application_list_->item(ii)->data(role_dir_index) );
+		if (!item_index.isValid())
+			continue;
+		if (item_index.toInt() > dir_index || (item_index.toInt() == dir_index &&
+		    application_list_->item(ii)->data(role_directory).toString() > app_dir.directory)) {
+			row = ii;
+			break;
+		}
+	}
+
+	bool found_any = false;
+	for (auto &header : app_dir.files) {
+		if (header.type != type)
+			continue;
+		if (!found_any) { //display the directory's path as a list separator
+			addInfoSeparator(app_dir.directory, row);
+			application_list_->item(row)->setData(role_directory, app_dir.directory);
+			application_list_->item(row++)->setData(role_dir_index, dir_index);
+			found_any = true;
+		}
+		auto *app( createApplication(header) );
+		app->setData(role_directory, app_dir.directory);
+		app->setData(role_dir_index, dir_index);
+		application_list_->insertItem(row++, app);
+	}
+	if (found_any) //after the list has been laid out
+		QTimer::singleShot(0, this, &ApplicationsView::loadVisibleIcons);
+}
+
+/**
+ * @brief Remove all items that were found in a certain directory.
+ * @param[in] directory The search directory to remove from the list.
+ */
+void ApplicationsView::removeDirectory(const QString &directory)
+{
+	for (int ii = application_list_->count() - 1; ii >= 0; --ii) {
+		if (application_list_->item(ii)->data(role_directory).toString() == directory)
+			delete application_list_->takeItem(ii);
 	}
-	app->setData(Qt::UserRole, file.fileName()); //store the full file path
-	app->setToolTip(file.fileName()); //(stored twice in case the ToolTip changes at some point)
-	application_list_->addItem(app);
 }
 
 /**
  * @brief Add a non-clickable item to the list to mark different sections.
  * @param[in] text Text of the item.
- * @param[in] index Position to insert the separator. This can be set because we run through paths
- * first, and retrospectively insert it in case files were actually found.
+ * @param[in] index Position to insert the separator.
  */
 void ApplicationsView::addInfoSeparator(const QString &text, const int &index)
 {
@@ -102,6 +161,85 @@ void ApplicationsView::addInfoSeparator(const QString &text, const int &index)
 	application_list_->insertItem(index, dir_sep);
 }
 
+/**
+ * @brief Show an info text if the list is empty, or remove it if it's not.
+ * @param[in] text The info text to display for an empty list.
+ */
+void ApplicationsView::setEmptyInfo(const QString &text)
+{
+	for (int ii = application_list_->count() - 1; ii >= 0; --ii) {
+		if (application_list_->item(ii)->data(role_empty_info).toBool())
+			delete application_list_->takeItem(ii);
+	}
+	if (application_list_->count() > 0)
+		return;
+	addInfoSeparator(text, 0);
+	application_list_->item(0)->setData(role_empty_info, true);
+}
+
+/**
+ * @brief Request the icons of all items that are currently visible in the list.
+ * @details Only the rows between the top and the bottom of the viewport are looked at.
+ * Icons are decoded in the background by the icon cache and set in onIconLoaded().
+ */
+void ApplicationsView::loadVisibleIcons()
+{
+	if (!isVisible() || application_list_->count() == 0)
+		return;
+	const QRect view_rect( application_list_->viewport()->rect() );
+	const QModelIndex first_index( application_list_->indexAt(view_rect.topLeft()) );
+	const QModelIndex last_index( application_list_->indexAt(view_rect.bottomLeft()) );
+	const int first_row = first_index.isValid()? first_index.row() : 0;
+	const int last_row = last_index.isValid()? last_index.row() : application_list_->count() - 1;
+	for (int ii = first_row; ii <= last_row; ++ii) {
+		auto *item( application_list_->item(ii) );
+		const QString icon_file( item->data(role_icon_file).toString() );
+		if (icon_file.isEmpty())
+			continue;
+		const QIcon icon( icon_cache_->getIcon(icon_file) );
+		if (!icon.isNull()) { //was already cached
+			item->setIcon(icon);
+			item->setData(role_icon_file, QVariant());
+		}
+	}
+}
+
+/**
+ * @brief Event listener for an icon that has been loaded in the background.
+ * @param[in] icon_file The icon's file name.
+ * @param[in] icon The loaded icon.
+ */
+void ApplicationsView::onIconLoaded(const QString &icon_file, const QIcon &icon)
+{
+	for (int ii = 0; ii < application_list_->count(); ++ii) {
+		auto *item( application_list_->item(ii) );
+		if (item->data(role_icon_file).toString() == icon_file) {
+			item->setIcon(icon);
+			item->setData(role_icon_file, QVariant());
+		}
+	}
+}
+
+/**
+ * @brief Load icons of items that become visible when the list is shown.
+ * @param[in] event The show event.
+ */
+void ApplicationsView::showEvent(QShowEvent *event)
+{
+	QWidget::showEvent(event);
+	QTimer::singleShot(0, this, &ApplicationsView::loadVisibleIcons);
+}
+
+/**
+ * @brief Load icons of items that become visible when the list is resized.
+ * @param[in] event The resize event.
+ */
+void ApplicationsView::resizeEvent(QResizeEvent *event)
+{
+	QWidget::resizeEvent(event);
+	loadVisibleIcons();
+}
+
 /**
  * @brief Create the list's context menu.
  */
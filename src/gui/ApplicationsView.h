@@ -24,11 +24,16 @@
 #ifndef APPLICATIONSVIEW_H
 #define APPLICATIONSVIEW_H
 
+#include "src/gui/IconCache.h"
+#include "src/main/AppScanner.h"
+
 #include <QDir>
 #include <QFile>
 #include <QListWidget>
 #include <QMenu>
 #include <QPoint>
+#include <QResizeEvent>
+#include <QShowEvent>
 #include <QString>
 #include <QWidget>
 
@@ -36,22 +41,32 @@ class ApplicationsView : public QWidget {
 	Q_OBJECT
 
 	public:
-		explicit ApplicationsView(QString tag_name, QWidget *parent = nullptr);
-		void addApplication(const QFile &file, const QRegularExpressionMatch &match_inishell);
+		explicit ApplicationsView(QString tag_name, IconCache *icon_cache, QWidget *parent = nullptr);
+		void setDirectory(const AppDirectory &app_dir, const QString &type);
+		void removeDirectory(const QString &directory);
 		void addInfoSeparator(const QString &text, const int &index);
+		void setEmptyInfo(const QString &text);
 		void clear() { application_list_->clear(); }
 		int count() const { return application_list_->count(); }
 
+	protected:
+		void showEvent(QShowEvent *event) override;
+		void resizeEvent(QResizeEvent *event) override;
+
 	private:
+		QListWidgetItem * createApplication(const AppHeader &header) const;
 		void createContextMenu();
 
 		QListWidget *application_list_ = nullptr;
+		IconCache *icon_cache_ = nullptr; //shared between the lists
 		QMenu list_context_menu_;
 		QString tag_name_;
 
 	private slots:
 		void onListDoubleClick(QListWidgetItem *item);
 		void showListContextMenu(const QPoint &coords);
+		void loadVisibleIcons();
+		void onIconLoaded(const QString &icon_file, const QIcon &icon);
 };
 
 #endif //APPLICATIONSVIEW_H
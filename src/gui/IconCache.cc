@@ -0,0 +1,177 @@
+/*****************************************************************************/
+/*  Copyright 2019 WSL Institute for Snow and Avalanche Research  SLF-DAVOS  */
+/*****************************************************************************/
+/* This file is part of INIshell.
+   INIshell is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   INIshell is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with INIshell.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "IconCache.h"
+#include "src/main/constants.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileIconProvider>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QImageReader>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPixmap>
+#include <QStandardPaths>
+#include <QtConcurrent/QtConcurrentRun>
+
+/**
+ * @class IconCache
+ * @brief Default constructor for the icon cache.
+ * @param[in] parent The parent object.
+ */
+IconCache::IconCache(QObject *parent) : QObject(parent)
+{
+	memory_cache_.setMaxCost(Cst::icon_cache_memory_kb); //cost is counted in kB
+}
+
+/**
+ * @brief Get the icon for an image file.
+ * @details If the icon is not in the memory cache yet it is loaded on a worker thread (from the
+ * disk cache if available) and iconLoaded() is emitted when it's ready. Both caches are keyed by
+ * the file's path and modification time, so an icon that was changed on disk is loaded again.
+ * Files that can not be read get the default icon and are not cached, i. e. they are tried again
+ * next time.
+ * @param[in] icon_file The image file to display as icon.
+ * @return The icon, or a null icon if it is not loaded yet.
+ */
+QIcon IconCache::getIcon(const QString &icon_file)
+{
+	const QFileInfo icon_info( icon_file );
+	if (!icon_info.isFile())
+		return getDefaultIcon();
+	const QString key( icon_file + "@" + QString::number(icon_info.lastModified().toMSecsSinceEpoch()) );
+	if (const QIcon *cached = memory_cache_.object(key))
+		return *cached;
+	if (pending_.contains(key))
+		return QIcon();
+
+	pending_.insert(key);
+	static const QString cache_dir( getCacheDir() );
+	auto *watcher( new QFutureWatcher<QImage>(this) );
+	connect(watcher, &QFutureWatcher<QImage>::finished, this, [=]() {
+		pending_.remove(key);
+		const QImage thumb( watcher->result() );
+		watcher->deleteLater();
+		if (thumb.isNull()) { //don't remember failures
+			emit iconLoaded(icon_file, getDefaultIcon());
+			return;
+		}
+		const QIcon icon( QPixmap::fromImage(thumb) ); //pixmaps can only be created on the GUI thread
+		memory_cache_.insert(key, new QIcon(icon), qMax(1, thumb.width() * thumb.height() * 4 / 1024));
+		emit iconLoaded(icon_file, icon);
+	});
+	watcher->setFuture(QtConcurrent::run(&IconCache::loadThumbnail, icon_file, key, cache_dir));
+	return QIcon();
+}
+
+/**
+ * @brief The icon to display for applications without their own icon.
+ * @details All lists share a single icon provider.
+ * @return The default file icon.
+ */
+QIcon IconCache::getDefaultIcon()
+{
+	static const QFileIconProvider icon_provider;
+	static const QIcon default_icon( icon_provider.icon(QFileIconProvider::File) );
+	return default_icon;
+}
+
+/**
+ * @brief Decode an icon file to a thumbnail (runs on a worker thread).
+ * @details A thumbnail found in the disk cache is used directly (and marked as recently used),
+ * otherwise the image is decoded at thumbnail size and written to the disk cache.
+ * @param[in] icon_file The image file to load.
+ * @param[in] key The cache key (icon path and modification time).
+ * @param[in] cache_dir The disk cache directory.
+ * @return The thumbnail, or a null image if the file could not be read.
+ */
+QImage IconCache::loadThumbnail(const QString &icon_file, const QString &key, const QString &cache_dir)
+{
+	QImage thumb;
+	const QString thumb_file( cache_dir + "/" + QString(QCryptographicHash::hash(key.toUtf8(),
+	    QCryptographicHash::Md5).toHex()) + ".png" );
+	QFile cached_file(thumb_file);
+	if (cached_file.exists() && cached_file.open(QIODevice::ReadWrite) && thumb.load(&cached_file, "PNG")) {
+		//the disk cache is pruned by modification time, so keep thumbnails in use:
+		cached_file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+		return thumb;
+	}
+
+	QImageReader reader(icon_file);
+	const QSize full_size( reader.size() );
+	if (full_size.isValid() && (full_size.width() > Cst::icon_thumbnail_size ||
+	    full_size.height() > Cst::icon_thumbnail_size)) //decode only as much as we need
+		reader.setScaledSize(full_size.scaled(Cst::icon_thumbnail_size, Cst::icon_thumbnail_size,
+		    Qt::KeepAspectRatio));
+	thumb = reader.read();
+	if (thumb.isNull())
+		return thumb;
+
+	QDir().mkpath(cache_dir);
+	if (thumb.save(thumb_file, "PNG"))
+		pruneDiskCache(cache_dir, QFileInfo( thumb_file ).size());
+	return thumb;
+}
+
+/**
+ * @brief Remove the least recently used thumbnails if the disk cache exceeds its size limit.
+ * @details The directory is only listed when the cache's estimated size (as of the last listing
+ * plus what was written since) goes over the limit. It is then pruned to a lower size, so that
+ * a couple of new thumbnails fit in before the next listing is due.
+ * @param[in] cache_dir The disk cache directory.
+ * @param[in] added_size Size of the thumbnail that was just written.
+ */
+void IconCache::pruneDiskCache(const QString &cache_dir, const qint64 &added_size)
+{
+	static QMutex prune_mutex; //several thumbnails may be written at the same time
+	static qint64 estimated_size = -1; //unknown until the directory is listed the first time
+	QMutexLocker lock(&prune_mutex);
+	if (estimated_size >= 0) {
+		estimated_size += added_size;
+		if (estimated_size <= static_cast<qint64>(Cst::icon_cache_disk_kb) * 1024)
+			return;
+	}
+	const QFileInfoList thumbs( QDir(cache_dir).entryInfoList(QStringList("*.png"), QDir::Files,
+	    QDir::Time) ); //most recently used first
+	qint64 total_size = 0;
+	for (auto &thumb : thumbs)
+		total_size += thumb.size();
+	if (total_size > static_cast<qint64>(Cst::icon_cache_disk_kb) * 1024) {
+		total_size = 0;
+		for (auto &thumb : thumbs) {
+			if (total_size + thumb.size() > static_cast<qint64>(Cst::icon_cache_disk_pruned_kb) * 1024)
+				QFile::remove(thumb.absoluteFilePath());
+			else
+				total_size += thumb.size();
+		}
+	}
+	estimated_size = total_size;
+}
+
+/**
+ * @brief Get the directory of the disk cache.
+ * @return Path to the thumbnail directory in the system's cache location.
+ */
+QString IconCache::getCacheDir()
+{
+	return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/icons";
+}
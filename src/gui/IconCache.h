@@ -0,0 +1,55 @@
+/*****************************************************************************/
+/*  Copyright 2019 WSL Institute for Snow and Avalanche Research  SLF-DAVOS  */
+/*****************************************************************************/
+/* This file is part of INIshell.
+   INIshell is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   INIshell is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with INIshell.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Loads application icons in the background and keeps size-bounded thumbnail caches
+ * in memory and on disk.
+ * 2020-05
+ */
+
+#ifndef ICONCACHE_H
+#define ICONCACHE_H
+
+#include <QCache>
+#include <QIcon>
+#include <QImage>
+#include <QObject>
+#include <QSet>
+#include <QString>
+
+class IconCache : public QObject {
+	Q_OBJECT
+
+	public:
+		explicit IconCache(QObject *parent = nullptr);
+		QIcon getIcon(const QString &icon_file);
+		static QIcon getDefaultIcon();
+
+	signals:
+		void iconLoaded(const QString &icon_file, const QIcon &icon);
+
+	private:
+		static QImage loadThumbnail(const QString &icon_file, const QString &key, const QString &cache_dir);
+		static void pruneDiskCache(const QString &cache_dir, const qint64 &added_size);
+		static QString getCacheDir();
+
+		QCache<QString, QIcon> memory_cache_; //icon file and modification time -> icon
+		QSet<QString> pending_; //cache keys of the icons that are currently being loaded
+};
+
+#endif //ICONCACHE_H
@@ -22,16 +22,24 @@
 #include "src/main/inishell.h"
 #include "src/main/os.h"
 #include "src/main/settings.h"
+#include "src/gui_elements/DocumentModel.h"
 #include "src/gui_elements/gui_elements.h"
 #include "src/gui/WorkflowPanel.h"
 
 #include <QGroupBox>
 #include <QHBoxLayout>
 #include <QListWidget>
+#include <QPointer>
 #include <QPushButton>
+#include <QResizeEvent>
+#include <QScrollBar>
+#include <QShowEvent>
 #include <QSplitter>
+#include <QTimer>
 #include <QVBoxLayout>
 
+#include <algorithm>
+
 #ifdef DEBUG
 	#include <iostream>
 #endif
@@ -53,6 +61,7 @@ ScrollPanel::ScrollPanel(const QString &section, const QString &tab_color, QWidg
 	main_area_->setStyleSheet("QScrollArea {border: none}"); //we have one from the tabs already
 	main_group_ = new Group(QString(), QString(), false, false, false, false, QString(), QString(), tab_color);
 	main_area_->setWidget(main_group_);
+	connect(main_area_->verticalScrollBar(), &QScrollBar::valueChanged, this, &ScrollPanel::buildVisibleRows);
 
 	/* main layout */
 	auto *layout( new QVBoxLayout );
@@ -60,6 +69,18 @@ ScrollPanel::ScrollPanel(const QString &section, const QString &tab_color, QWidg
 	this->setLayout(layout);
 }
 
+/**
+ * @brief Destructor for a scroll panel.
+ * @details Elements that were never built leave the document model.
+ */
+ScrollPanel::~ScrollPanel()
+{
+	DocumentModel &model( DocumentModel::getShared() );
+	model.removeUnbuilt(main_group_);
+	for (auto &inc_row : incremental_rows_)
+		model.removeUnbuilt(inc_row.row);
+}
+
 /**
  * @brief Retrieve the main grouping element of a scroll panel (there is one per tab).
  * @return The main Group of this scroll panel holding all widgets.
@@ -69,6 +90,223 @@ Group * ScrollPanel::getGroup() const
 	return this->main_group_;
 }
 
+/**
+ * @brief Remember an XML node to build into this panel when it is first needed.
+ * @details Building all tabs of large applications up front takes long, so top level frames and
+ * panels can be deferred until their tab is shown or receives INI values.
+ * @param[in] node The XML node of the frame or panel.
+ * @param[in] section The section the node is built for.
+ */
+void ScrollPanel::addPendingNode(const QDomNode &node, const QString &section)
+{
+	pending_nodes_.push_back(qMakePair(node, section));
+	//the model writes unbuilt panels from their XML:
+	DocumentModel::getShared().addUnbuiltNode(main_group_, node, section, !clear_on_build_);
+}
+
+/**
+ * @brief Build all frames and panels of this tab that have been deferred.
+ * @details For very large sections only placeholders are created at first, and the elements are
+ * built as they are scrolled into view (or as INI values are set for them).
+ */
+void ScrollPanel::buildPendingNodes()
+{
+	QList<QPair<QDomNode, QString>> nodes;
+	nodes.swap(pending_nodes_); //building may query this tab again
+	DocumentModel::getShared().removeUnbuilt(main_group_);
+	if (nodes.size() > Cst::incremental_rows_min_count) {
+		createIncrementalRows(nodes);
+		return;
+	}
+	for (auto &node : nodes)
+		buildElement(node.first, main_group_, node.second);
+	if (clear_on_build_)
+		clearNewPanels(main_group_);
+}
+
+/**
+ * @brief Build the rows of a large section that handle certain INI keys.
+ * @param[in] keys The INI keys (without section) to build the panels for.
+ */
+void ScrollPanel::buildRowsForKeys(const QStringList &keys)
+{
+	if (pending_rows_ == 0)
+		return;
+	std::vector<size_t> indices;
+	for (auto &key : keys) {
+		for (auto it = row_keys_.find(key.toLower()); it != row_keys_.end() &&
+		    it.key() == key.toLower(); ++it)
+			indices.push_back(it.value());
+	}
+	buildRows(indices);
+}
+
+/**
+ * @brief Set whether panels that are built later should be cleared instead of showing defaults.
+ * @param[in] clear_on_build True if the GUI was cleared without default values.
+ */
+void ScrollPanel::setClearOnBuild(const bool &clear_on_build)
+{
+	clear_on_build_ = clear_on_build;
+	DocumentModel &model( DocumentModel::getShared() );
+	model.setUnbuiltDefaults(main_group_, !clear_on_build);
+	if (pending_rows_ == 0)
+		return;
+	for (auto &inc_row : incremental_rows_) {
+		if (!inc_row.built)
+			model.setUnbuiltDefaults(inc_row.row, !clear_on_build);
+	}
+}
+
+/**
+ * @brief Event listener for size changes: more rows may have become visible.
+ * @param[in] event The resize event.
+ */
+void ScrollPanel::resizeEvent(QResizeEvent *event)
+{
+	Atomic::resizeEvent(event);
+	if (pending_rows_ > 0) //wait for the layout to settle
+		QTimer::singleShot(0, this, &ScrollPanel::buildVisibleRows);
+}
+
+/**
+ * @brief Event listener for when the tab is shown: its rows can be positioned now.
+ * @param[in] event The show event.
+ */
+void ScrollPanel::showEvent(QShowEvent *event)
+{
+	Atomic::showEvent(event);
+	if (pending_rows_ > 0)
+		QTimer::singleShot(0, this, &ScrollPanel::buildVisibleRows);
+}
+
+/**
+ * @brief Create placeholders for the top level elements of a large section.
+ * @details Elements containing dynamic panels (Replicator, Selector) are built right away because
+ * the INI keys they handle are only known after they exist. For the others, the keys of the
+ * whole subtree are indexed so that they can be built when INI values are set for them.
+ * @param[in] nodes The XML nodes to build, and the sections they are built for.
+ */
+void ScrollPanel::createIncrementalRows(const QList<QPair<QDomNode, QString>> &nodes)
+{
+	std::vector<size_t> eager_rows;
+	incremental_rows_.reserve(incremental_rows_.size() + static_cast<size_t>(nodes.size()));
+	for (auto &node : nodes) {
+		IncrementalRow inc_row;
+		inc_row.row = new Group(QString(), QString(), false, false, false, true); //tight
+		inc_row.row->setMinimumHeight(Cst::placeholder_row_height);
+		inc_row.node = node.first;
+		inc_row.section = node.second;
+		main_group_->addWidget(inc_row.row);
+		DocumentModel::getShared().addUnbuiltNode(inc_row.row, node.first, node.second, !clear_on_build_);
+
+		QStringList keys;
+		if (collectKeys(node.first, keys)) {
+			for (auto &key : keys)
+				row_keys_.insert(key.toLower(), incremental_rows_.size());
+		} else {
+			eager_rows.push_back(incremental_rows_.size());
+		}
+		incremental_rows_.push_back(inc_row);
+		++pending_rows_;
+	}
+	buildRows(eager_rows);
+	QTimer::singleShot(0, this, &ScrollPanel::buildVisibleRows); //when the layout is done
+}
+
+/**
+ * @brief Build the elements of some rows of a large section into their placeholders.
+ * @param[in] indices Indices of the rows to build. Rows that are already built are skipped.
+ */
+void ScrollPanel::buildRows(const std::vector<size_t> &indices)
+{
+	bool any_built = false;
+	const bool updates_enabled = updatesEnabled();
+	for (auto idx : indices) {
+		IncrementalRow &inc_row( incremental_rows_.at(idx) );
+		if (inc_row.built)
+			continue;
+		if (!any_built) { //only start a batch if there is something to do
+			setUpdatesEnabled(false);
+			Atomic::beginBatchUpdate();
+			any_built = true;
+		}
+		inc_row.built = true; //before building, in case the build queries this tab again
+		--pending_rows_;
+		DocumentModel::getShared().removeUnbuilt(inc_row.row);
+		buildElement(inc_row.node, inc_row.row, inc_row.section);
+		inc_row.row->setMinimumHeight(0);
+		if (clear_on_build_)
+			clearNewPanels(inc_row.row);
+	}
+	if (!any_built)
+		return;
+	(void) Atomic::endBatchUpdate();
+	setUpdatesEnabled(updates_enabled);
+}
+
+/**
+ * @brief Build the rows of a large section that are in or near the visible area.
+ * @details One screen height above and below the viewport is built in advance so that scrolling
+ * does not show empty placeholders. The rows are sorted vertically, so a binary search finds the
+ * first visible one.
+ */
+void ScrollPanel::buildVisibleRows()
+{
+	if (pending_rows_ == 0 || !main_area_->isVisible()) //hidden tabs have no valid geometry
+		return;
+	main_group_->layout()->activate(); //make sure the placeholders are in place
+	main_group_->getLayout()->activate();
+	const int margin = main_area_->viewport()->height();
+	const int top = main_area_->verticalScrollBar()->value() - margin;
+	const int bottom = main_area_->verticalScrollBar()->value() + main_area_->viewport()->height() + margin;
+	const auto row_bottom = [this](const IncrementalRow &inc_row) {
+		return inc_row.row->mapTo(main_group_, QPoint(0, inc_row.row->height())).y(); };
+
+	auto first = std::partition_point(incremental_rows_.begin(), incremental_rows_.end(),
+	    [&](const IncrementalRow &inc_row) { return row_bottom(inc_row) < top; });
+	std::vector<size_t> indices;
+	for (auto it = first; it != incremental_rows_.end(); ++it) {
+		if (it->row->mapTo(main_group_, QPoint(0, 0)).y() > bottom)
+			break;
+		indices.push_back(static_cast<size_t>(it - incremental_rows_.begin()));
+	}
+	buildRows(indices);
+}
+
+/**
+ * @brief Clear panels that were built after the GUI was cleared without defaults.
+ * @param[in] parent The widget holding the new panels.
+ */
+void ScrollPanel::clearNewPanels(QWidget *parent) const
+{
+	const QList<Atomic *> panel_list( parent->findChildren<Atomic *>() );
+	for (auto &panel : panel_list)
+		panel->clear(false);
+}
+
+/**
+ * @brief Collect the INI keys of an XML element and all of its children.
+ * @param[in] node The XML node to search.
+ * @param[out] keys The INI keys that were found.
+ * @return False if the element contains dynamic panels whose keys are not known beforehand.
+ */
+bool ScrollPanel::collectKeys(const QDomNode &node, QStringList &keys)
+{
+	const QDomElement element( node.toElement() );
+	const QString key( element.attribute("key") );
+	if (key.contains("#") || key.contains("%") || key.contains("*") || element.attribute("replicate").toLower() == "true" ||
+	    element.attribute("template").toLower() == "true" || element.attribute("type").toLower() == "selector")
+		return false;
+	if (!key.isEmpty())
+		keys.push_back(key);
+	for (QDomNode child = node.firstChildElement(); !child.isNull(); child = child.nextSiblingElement()) {
+		if (!collectKeys(child, keys))
+			return false;
+	}
+	return true;
+}
+
 /**
  * @class MainPanel
  * @brief Constructor for the main panel, i. e. the tab widget with scroll area children.
@@ -80,8 +318,10 @@ MainPanel::MainPanel(QWidget *parent) : QWidget(parent)
 	workflow_panel_ = new WorkflowPanel;
 	workflow_stack_ = new QStackedWidget;
 	section_tab_ = new QTabWidget;
+	DocumentModel::getShared().setSectionTabs(section_tab_); //panels outside of it don't count
 	section_tab_->setTabsClosable(true);
 	connect(section_tab_, &QTabWidget::tabCloseRequested, this, &MainPanel::onTabCloseRequest);
+	connect(section_tab_, &QTabWidget::currentChanged, this, &MainPanel::onTabChanged);
 	workflow_stack_->addWidget(section_tab_);
 
 	/* main layout */
@@ -149,19 +389,18 @@ ScrollPanel * MainPanel::getSectionScrollArea(const int &index)
 }
 
 /**
- * @brief Run through panels and query their user-set values.
- * @details This function finds all panel classes, gets their set values, and modifies the
- * corresponding INI setting. It also performs checks for missing values.
- * Note: Originally INI values were updated live in the panels on input, eliminating the need
- * for this loop. However, more and more intermediate loops needed to be introduced (for example
- * to deactivate panels that are hidden by a parent element like a Dropdown or Choice).
- * Furthermore, dealing with missing mandatory values and keys that are present multiple times
- * (e. g. needing to check if a second panel manipulates the same key before deleting it in a
- * Selector) convoluted the program so heavily that this solution is much cleaner and more robust.
+ * @brief Query the panels' user-set values.
+ * @details The panels keep the DocumentModel up to date with their values and with being shown
+ * or hidden by a parent element like a Dropdown or Choice. Here, the model is written to the
+ * INIParser, which also performs checks for missing values. Keys that are present multiple
+ * times are handled like before: only the visible panels contribute. Tabs and rows that are
+ * not built yet are written from the XML, so nothing has to be built for this.
  * @param[in] ini The INIParser for which to set the values (the one that will be output).
+ * @param[in] with_unbuilt Also write tabs and rows that are not built yet. They can be skipped
+ * when comparing with the loaded INI file since the user can not have changed them.
  * @return A comma-separated list of missing mandatory INI keys.
  */
-QString MainPanel::setIniValuesFromGui(INIParser *ini)
+QString MainPanel::setIniValuesFromGui(INIParser *ini, const bool &with_unbuilt)
 {
 	//TODO: For some combination of properties (optional, will be defaulted by the
 	//software, ...) we may be able to skip output of some keys to avoid
@@ -170,29 +409,7 @@ QString MainPanel::setIniValuesFromGui(INIParser *ini)
 	//( !ini->get(section, key).isNull()) ) //key present in input INI file
 	//( is_mandatory ) //key is set non-optional
 
-	QString missing;
-	for (int ii = 0; ii < section_tab_->count(); ++ii) { //run through sections
-		const QWidget *section_tab( section_tab_->widget(ii) );
-		const QList<Atomic *> panel_list( section_tab->findChildren<Atomic *>() );
-		for (auto &panel : panel_list) { //run through panels in section
-			if (!panel->isVisibleTo(section_tab)) //visible if section_tab was visible?
-				continue;
-			QString section, key;
-			const QString value( panel->getIniValue(section, key) );
-			if (panel->property("no_ini").toBool())
-				continue;
-			if (key.isNull()) //GUI element that is not an interactive panel
-				continue;
-
-			const bool is_mandatory = panel->property("is_mandatory").toBool();
-			if (is_mandatory && value.isEmpty()) //collect missing non-optional keys
-				missing += key + ", ";
-			if (!value.isEmpty())
-				ini->set(section, key, value, is_mandatory);
-		} //endfor panel_list
-	} //endfor ii
-	missing.chop(2); //trailing ", "
-	return missing;
+	return DocumentModel::getShared().serialize(ini, with_unbuilt); //the panels keep the model up to date
 }
 
 /**
@@ -267,7 +484,15 @@ void MainPanel::setSplitterSizes(QList<int> sizes)
  */
 void MainPanel::clearGuiElements()
 {
-	section_tab_->clear();
+	section_tab_->blockSignals(true); //don't build tabs that are being removed
+	while (section_tab_->count() > 0) {
+		QWidget *page( section_tab_->widget(0) );
+		section_tab_->removeTab(0);
+		delete page; //removing a tab keeps the page, and its panels would stay in the document model
+	}
+	section_tab_->blockSignals(false);
+	settings_tab_idx_ = -1;
+	clear_on_build_ = false;
 	workflow_panel_->clearXmlPanels();
 }
 
@@ -276,13 +501,67 @@ void MainPanel::clearGuiElements()
  */
 void MainPanel::clearGui(const bool &set_default)
 {
-	clearDynamicPanels<Replicator>(); //clear special panels (the ones that can produce INI keys)
-	clearDynamicPanels<Selector>(); //cf. notes there
+	setClearOnBuild(!set_default); //for panels that are not built yet
+	clearDynamicPanels(); //clear special panels (the ones that can produce INI keys)
 	const QList<Atomic *> panel_list( section_tab_->findChildren<Atomic *>() ); //clear all others
 	for (auto &panel : panel_list)
 		panel->clear(set_default);
 }
 
+/**
+ * @brief Set whether panels that are built later should be cleared instead of showing defaults.
+ * @param[in] clear_on_build True if the GUI was cleared without default values.
+ */
+void MainPanel::setClearOnBuild(const bool &clear_on_build)
+{
+	clear_on_build_ = clear_on_build;
+	for (int ii = 0; ii < section_tab_->count(); ++ii) {
+		if (ScrollPanel *tab_scroll = getSectionScrollArea(ii))
+			tab_scroll->setClearOnBuild(clear_on_build);
+	}
+}
+
+/**
+ * @brief Build the deferred contents of a section tab.
+ * @details Tabs are built when they are first shown, or when they are needed otherwise
+ * (INI values for them, expressions referencing their keys, ...). Very large sections are
+ * built further while scrolling.
+ * @param[in] tab_scroll The tab's ScrollPanel. Nothing is done if it is null or already built.
+ */
+void MainPanel::buildSectionTab(ScrollPanel *tab_scroll)
+{
+	if (tab_scroll == nullptr || !tab_scroll->hasPendingNodes())
+		return;
+	const bool updates_enabled = updatesEnabled();
+	setUpdatesEnabled(false); //disable painting until done
+	Atomic::beginBatchUpdate();
+	tab_scroll->buildPendingNodes();
+	(void) Atomic::endBatchUpdate();
+	setUpdatesEnabled(updates_enabled);
+}
+
+/**
+ * @brief Build the deferred contents of the tab of an INI section.
+ * @param[in] section The INI section to build. Nothing happens if no tab exists for it.
+ * @param[in] key If given, also build the panels for this key in a large section.
+ */
+void MainPanel::buildSection(const QString &section, const QString &key)
+{
+	ScrollPanel *tab_scroll( getSectionScrollarea(section, QString(), QString(), true) );
+	buildSectionTab(tab_scroll);
+	if (tab_scroll != nullptr && !key.isEmpty())
+		tab_scroll->buildRowsForKeys(QStringList(key));
+}
+
+/**
+ * @brief Build the deferred contents of the currently displayed tab.
+ */
+void MainPanel::buildCurrentTab()
+{
+	//the Info tab is no ScrollPanel, in which case the cast yields null:
+	buildSectionTab(qobject_cast<ScrollPanel *>(section_tab_->currentWidget()));
+}
+
 /**
  * @brief Prepare the GUI after settings window has been opened.
  * @details The XML describing INIshell's settings page is loaded by the main window, then this
@@ -306,6 +585,7 @@ int MainPanel::prepareSettingsTab()
 void MainPanel::closeSettingsTab()
 {
 	if (settings_tab_idx_ != -1) {
+		section_tab_->widget(settings_tab_idx_)->deleteLater(); //leave the document model
 		section_tab_->removeTab(settings_tab_idx_);
 		settings_tab_idx_ = -1;
 	}
@@ -317,21 +597,24 @@ void MainPanel::closeSettingsTab()
  */
 void MainPanel::displaySettings(const int &settings_tab_idx)
 {
+	const QWidget *settings_area( getSectionScrollArea(settings_tab_idx) );
 	const QStringList settings_list(getSimpleSettingsNames());
 	for (auto &set : settings_list) {
 		const QString string_value( getSetting(set, "value") );
-		auto *panel( getSectionScrollArea(settings_tab_idx)->findChild<Atomic *>(
-		    Atomic::getQtKey("SETTINGS::" + set)) );
-		if (panel) //no crash on XML errors
-			panel->setProperty("ini_value", string_value);
+		const QList<Atomic *> panel_list( Atomic::getPanels("SETTINGS::" + set, settings_area) );
+		if (!panel_list.isEmpty()) //no crash on XML errors
+			panel_list.first()->setValue(string_value);
 	}
 	const QStringList search_dirs( getListSetting("user::xmlpaths", "path") );
+	const QList<Atomic *> xml_panels( Atomic::getPanels("SETTINGS::user::xmlpaths::path#", settings_area) );
+	if (xml_panels.isEmpty())
+		return;
 	for (int ii = 1; ii <= search_dirs.size(); ++ii) {
-		auto *xml_panel = getSectionScrollArea(settings_tab_idx)->findChild<Replicator *>(Atomic::getQtKey("SETTINGS::user::xmlpaths::path#"));
-		xml_panel->setProperty("ini_value", ii);
-		auto *path_panel = getSectionScrollArea(settings_tab_idx)->findChild<Atomic *>(
-		    Atomic::getQtKey(QString("SETTINGS::user::xmlpaths::path%1").arg(ii)));
-		path_panel->setProperty("ini_value", search_dirs.at(ii-1));
+		xml_panels.first()->setValue(ii);
+		const QList<Atomic *> path_panels( Atomic::getPanels(
+		    QString("SETTINGS::user::xmlpaths::path%1").arg(ii), settings_area) );
+		if (!path_panels.isEmpty())
+			path_panels.first()->setValue(search_dirs.at(ii-1));
 	}
 }
 
@@ -400,6 +683,15 @@ void MainPanel::onTabCloseRequest(const int &idx)
 		getMainWindow()->closeSettings();
 }
 
+/**
+ * @brief Build a tab's contents when it is shown for the first time.
+ * @param[in] idx Index of the tab that is now displayed.
+ */
+void MainPanel::onTabChanged(const int &idx)
+{
+	buildSectionTab(getSectionScrollArea(idx));
+}
+
 /**
  * @brief Helper function to get a Settings page panel's value.
  * @param[in] parent The parent widget to search.
@@ -408,11 +700,10 @@ void MainPanel::onTabCloseRequest(const int &idx)
  */
 QString MainPanel::getShellSetting(QWidget *parent, const QString &option)
 {
-	const Atomic *option_element( parent->findChild<Atomic *>(
-	    Atomic::getQtKey("SETTINGS::" + option)) );
-	if (option_element) {
+	const QList<Atomic *> panel_list( Atomic::getPanels("SETTINGS::" + option, parent) );
+	if (!panel_list.isEmpty()) {
 		QString section, key; //unused here
-		return option_element->getIniValue(section, key);
+		return panel_list.first()->getIniValue(section, key);
 	}
 	return QString();
 }
@@ -450,27 +741,35 @@ void MainPanel::createExtraSettingsWidgets()
  * @details This function clears panels that have the ability to create and more importantly delete
  * an arbitrary number of child panels. Those stand for a group of INI keys rather than a single one,
  * and can create child panels for INI keys such as "STATION1, STATION2, ...".
+ * All dynamic panels are collected once and cleared deepest first, so that each item is only
+ * torn down once (the items go to the panels' pools for reuse).
  */
-template <class T>
 void MainPanel::clearDynamicPanels()
 {
-	/*
-	 * Fetching a list of suitable panels and iterating through them does not work out
-	 * because clearing one dynamic panel can delete another one, which means the pointers
-	 * we receive could be invalidated.
-	 * So, we look for the first dynamic panel with children, clear that, and start the
-	 * search again until there are no more dynamic panels with children found.
-	 */
-	const QList<T *> panel_list( section_tab_->findChildren<T *>() );
-	for (auto &pan : panel_list) {
-		//the panels themselves are not deleted, so we stop if it's empty:
-		if (pan->count() > 0) {
-			pan->clear();
-			clearDynamicPanels<T>(); //repeat until all dynamic panels are empty
-			return;
-		}
+	QList<QPair<int, QPointer<Atomic>>> dynamic_panels; //depth in the widget tree and panel
+	const QList<Atomic *> panel_list( section_tab_->findChildren<Atomic *>() );
+	for (auto &panel : panel_list) {
+		const auto *replicator( qobject_cast<Replicator *>(panel) );
+		const auto *selector( qobject_cast<Selector *>(panel) );
+		if ((replicator == nullptr || replicator->count() == 0) && (selector == nullptr || selector->count() == 0))
+			continue;
+		int depth = 0;
+		for (const QWidget *wid = panel; wid != nullptr && wid != section_tab_; wid = wid->parentWidget())
+			++depth;
+		dynamic_panels.push_back(qMakePair(depth, QPointer<Atomic>(panel)));
+	}
+	if (dynamic_panels.isEmpty())
+		return;
+	std::stable_sort(dynamic_panels.begin(), dynamic_panels.end(),
+	    [](const QPair<int, QPointer<Atomic>> &lhs, const QPair<int, QPointer<Atomic>> &rhs) {
+	    return lhs.first > rhs.first; });
+
+	section_tab_->setUpdatesEnabled(false); //one pass without painting
+	Atomic::beginBatchUpdate();
+	for (auto &dyn : dynamic_panels) {
+		if (!dyn.second.isNull()) //could be gone if the pool of a parent panel was full
+			dyn.second->clear();
 	}
+	(void) Atomic::endBatchUpdate();
+	section_tab_->setUpdatesEnabled(true);
 }
-//this is a list of panels that can produce and delete an aribtrary number of child panels:
-template void MainPanel::clearDynamicPanels<Selector>();
-template void MainPanel::clearDynamicPanels<Replicator>();
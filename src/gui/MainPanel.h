@@ -30,12 +30,30 @@
 #include "src/gui/WorkflowPanel.h"
 
 #include <QList>
+#include <QMultiHash>
+#include <QPair>
 #include <QStackedWidget>
 #include <QScrollArea>
 #include <QSplitter>
 #include <QString>
 #include <QTabWidget>
 #include <QWidget>
+#include <QtXml>
+
+#include <vector>
+
+/**
+ * @struct IncrementalRow
+ * @brief A top level element of a very large section that is only built when it is scrolled into view.
+ * @details Sections are built incrementally: a row that is built stays built, so the number of
+ * widgets grows with what has been viewed (or set from an INI file) rather than with the XML.
+ */
+struct IncrementalRow {
+	Group *row = nullptr; //placeholder in the section's main group
+	QDomNode node;
+	QString section;
+	bool built = false;
+};
 
 class ScrollPanel : public Atomic {
 	Q_OBJECT
@@ -43,11 +61,38 @@ class ScrollPanel : public Atomic {
 	public:
 		explicit ScrollPanel(const QString &section, const QString &tab_color,
 		    QWidget *parent = nullptr);
+		~ScrollPanel() override;
+		ScrollPanel(const ScrollPanel&) = delete;
+		ScrollPanel& operator =(ScrollPanel const&) = delete;
+		ScrollPanel(ScrollPanel&&) = delete;
+		ScrollPanel& operator=(ScrollPanel&&) = delete;
 		Group * getGroup() const;
+		void addPendingNode(const QDomNode &node, const QString &section);
+		bool hasPendingNodes() const { return !pending_nodes_.isEmpty() || pending_rows_ > 0; }
+		void buildPendingNodes();
+		void buildRowsForKeys(const QStringList &keys);
+		void setClearOnBuild(const bool &clear_on_build);
+
+	protected:
+		void resizeEvent(QResizeEvent *event) override;
+		void showEvent(QShowEvent *event) override;
 
 	private:
+		void createIncrementalRows(const QList<QPair<QDomNode, QString>> &nodes);
+		void buildRows(const std::vector<size_t> &indices);
+		void clearNewPanels(QWidget *parent) const;
+		static bool collectKeys(const QDomNode &node, QStringList &keys);
+
 		QScrollArea *main_area_ = nullptr;
 		Group *main_group_ = nullptr;
+		QList<QPair<QDomNode, QString>> pending_nodes_; //XML nodes (and their section) not built yet
+		std::vector<IncrementalRow> incremental_rows_; //in the order they are displayed
+		int pending_rows_ = 0; //number of rows that are not built yet
+		QMultiHash<QString, size_t> row_keys_; //INI key -> rows handling it
+		bool clear_on_build_ = false; //panels built later should not show default values
+
+	private slots:
+		void buildVisibleRows();
 };
 
 class MainPanel : public QWidget {
@@ -60,18 +105,23 @@ class MainPanel : public QWidget {
 		ScrollPanel * getSectionScrollArea(const int &index);
 		WorkflowPanel * getWorkflowPanel() const { return workflow_panel_; }
 		QStackedWidget * getWorkflowStack() const { return workflow_stack_; }
-		QString setIniValuesFromGui(INIParser *ini);
+		QString setIniValuesFromGui(INIParser *ini, const bool &with_unbuilt = true);
 		void displayInfo();
 		QList<int> getSplitterSizes() const;
 		void setSplitterSizes(QList<int> sizes = QList<int>());
 		void clearGuiElements();
 		void clearGui(const bool &set_default = true);
+		void setClearOnBuild(const bool &clear_on_build);
+		bool getClearOnBuild() const noexcept { return clear_on_build_; }
 		int prepareSettingsTab();
 		void closeSettingsTab();
 		bool hasSettingsLoaded() { return settings_tab_idx_ != -1; }
 		void displaySettings(const int &settings_tab_idx);
 		bool showTab(const QString &tab_name);
-		template <class T> void clearDynamicPanels();
+		void clearDynamicPanels();
+		void buildSectionTab(ScrollPanel *tab_scroll);
+		void buildSection(const QString &section, const QString &key = QString());
+		void buildCurrentTab();
 
 	private:
 		QString getShellSetting(QWidget *parent, const QString &option);
@@ -82,10 +132,12 @@ class MainPanel : public QWidget {
 		QTabWidget *section_tab_ = nullptr;
 		QSplitter *splitter_ = nullptr;
 		int settings_tab_idx_ = -1; //index of settings tab if loaded
+		bool clear_on_build_ = false; //GUI was cleared without defaults, cf. ScrollPanel
 
 	private slots:
 		void saveSettings(const int &settings_tab_idx);
 		void onTabCloseRequest(const int &idx);
+		void onTabChanged(const int &idx);
 };
 
 #endif //MAINPANEL_H
@@ -25,11 +25,14 @@
 #include "src/gui/AboutWindow.h"
 #include "src/gui_elements/Atomic.h"
 #include "src/gui_elements/Group.h" //to exclude Groups from panel search
+#include "src/gui_elements/Replicator.h" //bulk creation of numbered panels
 #include "src/main/colors.h"
 #include "src/main/common.h"
 #include "src/main/constants.h"
 #include "src/main/Error.h"
 #include "src/main/dimensions.h"
+#include "src/main/expressions.h"
+#include "src/main/FileStatCache.h"
 #include "src/main/INIParser.h"
 #include "src/main/inishell.h"
 #include "src/main/settings.h"
@@ -39,17 +42,23 @@
 #include <QCheckBox>
 #include <QDesktopServices>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFileDialog>
 #include <QFileInfo>
 #include <QGroupBox>
+#include <QHash>
 #include <QMenuBar>
 #include <QMessageBox>
-#include <QRegularExpression>
+#include <QPair>
+#include <QPointer>
+#include <QSet>
 #include <QSpacerItem>
 #include <QStatusBar>
+#include <QStyle>
 #include <QSysInfo>
 #include <QTimer>
 #include <QToolBar>
+#include <QVBoxLayout>
 
 #ifdef DEBUG
 	#include <iostream>
@@ -168,8 +177,23 @@ MainWindow::MainWindow(QString &settings_location, const QStringList &errors, QM
 	preview_ = new PreviewWindow(this);
 	/* create the dynamic GUI area */
 	control_panel_ = new MainPanel(this);
-	this->setCentralWidget(control_panel_);
+	document_tabs_ = new QTabBar; //one tab per open INI document, hidden if there is only one
+	document_tabs_->setDocumentMode(true);
+	document_tabs_->setTabsClosable(true);
+	document_tabs_->setExpanding(false);
+	document_tabs_->setAutoHide(true);
+	document_tabs_->addTab(tr("Untitled"));
+	connect(document_tabs_, &QTabBar::currentChanged, this, &MainWindow::switchIniDocument);
+	connect(document_tabs_, &QTabBar::tabCloseRequested, this, [=](int index) { (void) closeIniDocument(index); });
+	auto *central_widget( new QWidget(this) );
+	auto *central_layout( new QVBoxLayout(central_widget) );
+	central_layout->setContentsMargins(0, 0, 0, 0);
+	central_layout->setSpacing(0);
+	central_layout->addWidget(document_tabs_);
+	central_layout->addWidget(control_panel_);
+	this->setCentralWidget(central_widget);
 	ini_.setLogger(&logger_);
+	documents_.resize(1);
 	if (errors.isEmpty())
 		setStatus(tr("Ready."), "info");
 	else
@@ -193,19 +217,21 @@ MainWindow::~MainWindow()
  * This function initiates the recursive GUI building with an XML document that was
  * parsed beforehand.
  * @param[in] xml XML to build the gui from.
+ * @param[in] lazy_tabs Only build the currently shown tab, the others are built when needed.
  */
-void MainWindow::buildGui(const QDomDocument &xml)
+void MainWindow::buildGui(const QDomDocument &xml, const bool &lazy_tabs)
 {
 	setUpdatesEnabled(false); //disable painting until done
 	QDomNode root = xml.firstChild();
 	while (!root.isNull()) {
 		if (root.isElement()) { //skip over comments
 			//give no parent group - tabs will be created for top level:
-			recursiveBuild(root, nullptr, QString());
+			recursiveBuild(root, nullptr, QString(), false, lazy_tabs);
 			break;
 		}
 		root = root.nextSibling();
 	}
+	control_panel_->buildCurrentTab();
 	setUpdatesEnabled(true);
 }
 
@@ -216,12 +242,14 @@ void MainWindow::buildGui(const QDomDocument &xml)
  */
 QList<Atomic *> MainWindow::getPanelsForKey(const QString &ini_key)
 {
-	QList<Atomic *> panel_list( control_panel_->findChildren<Atomic *>(Atomic::getQtKey(ini_key)) );
-	for (auto it = panel_list.begin(); it != panel_list.end(); ++it) {
+	//the key may be in a tab or row that is not built yet:
+	control_panel_->buildSection(ini_key.section(Cst::sep, 0, 0), ini_key.section(Cst::sep, 1));
+	QList<Atomic *> panel_list;
+	for (auto *panel : Atomic::getPanels(ini_key, control_panel_)) {
 		//groups don't count towards finding INI keys (for this reason, they additionally
 		//have the "no_ini" key set):
-		if (qobject_cast<Group *>(*it))
-			panel_list.erase(it);
+		if (!qobject_cast<Group *>(panel))
+			panel_list.push_back(panel);
 	}
 	return panel_list;
 }
@@ -231,8 +259,10 @@ QList<Atomic *> MainWindow::getPanelsForKey(const QString &ini_key)
  * @details This function calls the underlying function that does this and displays a message if
  * the user has neglected to set some mandatory INI values.
  * @param[in] filename The file to save to. If not given, the current INI file will be used.
+ * @param[in] resolve_expressions Replace expressions with their values so that the INI file can be
+ * read without evaluating them.
  */
-void MainWindow::saveIni(const QString &filename)
+void MainWindow::saveIni(const QString &filename, const bool &resolve_expressions)
 {
 	/*
 	 * We keep the original INIParser as-is, i. e. we always keep the INI file as it was loaded
@@ -257,14 +287,20 @@ void MainWindow::saveIni(const QString &filename)
 		if (clicked == QMessageBox::Cancel)
 			return;
 	}
+	if (resolve_expressions) { //all keys in one pass, referenced ones first
+		for (auto &error : expr::resolveIniExpressions(gui_ini))
+			logger_.log(tr("Expression not resolved: ") + error, "warning");
+	}
 	//if no file is specified we save to the currently open INI file (save vs. save as):
 	gui_ini.writeIni(filename.isEmpty()? gui_ini.getFilename() : filename);
 }
 
 /**
- * @brief Save the currently set values to a new INI file.
+ * @brief Let the user select a file to save an INI file to.
+ * @param[in] caption Title of the file dialog.
+ * @return The selected file, or a null string if the dialog was cancelled.
  */
-void MainWindow::saveIniAs()
+QString MainWindow::selectIniSaveFile(const QString &caption)
 {
 	QString start_path( getSetting("auto::history::last_ini", "path") );
 	if (start_path.isEmpty())
@@ -272,14 +308,22 @@ void MainWindow::saveIniAs()
 	if (start_path.isEmpty())
 		start_path = QDir::currentPath();
 
-	const QString filename = QFileDialog::getSaveFileName(this, tr("Save INI file"),
-	    start_path + "/" + ini_filename_->text(),
+	return QFileDialog::getSaveFileName(this, caption, start_path + "/" + ini_filename_->text(),
 	    "INI files (*.ini *.INI);;All files (*)", nullptr, QFileDialog::DontUseNativeDialog);
+}
+
+/**
+ * @brief Save the currently set values to a new INI file.
+ */
+void MainWindow::saveIniAs()
+{
+	const QString filename( selectIniSaveFile(tr("Save INI file")) );
 	if (filename.isNull()) //cancelled
 		return;
 	saveIni(filename);
 	ini_.setFilename(filename); //the new file is the new current file like in all programs
 	ini_filename_->setText(filename);
+	updateDocumentTab();
 	autoload_->setVisible(true); //if started from an empty GUI, this could still be disabled
 	toolbar_save_ini_->setEnabled(true); //toolbar entry
 	file_save_ini_->setEnabled(true); //menu entry
@@ -287,6 +331,20 @@ void MainWindow::saveIniAs()
 	setSetting("auto::history::last_ini", "path", QFileInfo( filename ).absoluteDir().path());
 }
 
+/**
+ * @brief Export the currently set values with all expressions replaced by their values.
+ * @details This is meant for software that can not evaluate the expressions itself. The current
+ * INI file stays the same so that the expressions are kept there.
+ */
+void MainWindow::saveIniResolved()
+{
+	const QString filename( selectIniSaveFile(tr("Save INI file with resolved expressions")) );
+	if (filename.isNull()) //cancelled
+		return;
+	saveIni(filename, true);
+	setSetting("auto::history::last_ini", "path", QFileInfo( filename ).absoluteDir().path());
+}
+
 /**
  * @brief Select a path for an INI file to be opened, and then open it.
  */
@@ -308,25 +366,42 @@ void MainWindow::openIni()
 
 /**
  * @brief Set the loaded panels' values from an INI file.
+ * @details All values are set in one batch: painting is disabled and the panels' styles are
+ * refreshed only once at the end instead of with every value.
  * @param[in] ini The INI file in form of an INIParser (usually the main one).
  * @return True if all INI keys are known to the loaded XML.
  */
 bool MainWindow::setGuiFromIni(const INIParser &ini)
 {
+	QElapsedTimer timer;
+	timer.start();
+	const bool updates_enabled = updatesEnabled();
+	setUpdatesEnabled(false); //disable painting until done
+	Atomic::beginBatchUpdate();
+	expr::ExpressionGraph::getShared().clearValues(); //expressions may refer to keys without panels
+
 	bool all_ok = true;
 	bool first_error_message = true;
 	for (auto &sec : ini.getSectionsCopy()) { //run through sections in INI file
 		ScrollPanel *tab_scroll = getControlPanel()->getSectionScrollarea(sec.getName(),
 		    QString(), QString(), true); //get the corresponding tab of our GUI
 		if (tab_scroll != nullptr) { //section exists in GUI
+			control_panel_->buildSectionTab(tab_scroll);
 			const auto kv_list( sec.getKeyValueList() );
+			QStringList keys;
+			for (auto &kv : kv_list)
+				keys.push_back(kv.first);
+			tab_scroll->buildRowsForKeys(keys); //rows of large sections that are still placeholders
+			createDynamicPanels(tab_scroll, sec); //all Replicator and Selector children in one go
 			for (size_t ii = 0; ii < kv_list.size(); ++ii) {
 				//find the corresponding panel, and try to create it for dynamic panels
 				//(e. g. Selector, Replicator):
 				QWidgetList widgets( findPanel(tab_scroll, sec, *sec[ii]) );
 				if (!widgets.isEmpty()) {
-					for (int jj = 0; jj < widgets.size(); ++jj) //multiple panels can share the same key
-						widgets.at(jj)->setProperty("ini_value", sec[ii]->getValue());
+					for (int jj = 0; jj < widgets.size(); ++jj) { //multiple panels can share the same key
+						if (auto *panel = qobject_cast<Atomic *>(widgets.at(jj)))
+							panel->setValue(sec[ii]->getValue());
+					}
 				} else {
 					sec[ii]->setIsUnknownToApp();
 					writeGuiFromIniHeader(first_error_message, ini);
@@ -342,6 +417,12 @@ bool MainWindow::setGuiFromIni(const INIParser &ini)
 			all_ok = false;
 		} //endif section exists
 	} //endfor sec
+
+	const int restyled = Atomic::endBatchUpdate();
+	setUpdatesEnabled(updates_enabled);
+	if (restyled >= 0) //the widgets are only restyled when the outermost batch ends
+		logger_.log(tr("INI values applied to the GUI in %1 ms (%2 widgets restyled)").arg(
+		    timer.elapsed()).arg(restyled));
 	return all_ok;
 }
 
@@ -367,6 +448,7 @@ void MainWindow::openIni(const QString &path, const bool &is_autoopen, const boo
 	file_save_ini_->setEnabled(true);
 	autoload_->setVisible(true);
 	ini_filename_->setText(path);
+	updateDocumentTab();
 	autoload_box_->setText(tr("autoload this INI for ") + current_application_);
 	if (!is_autoopen) //when a user clicks an INI file to open it we ask anew whether to autoopen
 		autoload_box_->setCheckState(Qt::Unchecked);
@@ -379,21 +461,24 @@ void MainWindow::openIni(const QString &path, const bool &is_autoopen, const boo
  * @brief Close the currently opened INI file.
  * @details This function checks whether the user has made changes to the INI file and if yes,
  * allows to save first, discard changes, or cancel the operation.
+ * @param[in] check_unsaved Set to false if the document is known to have no unsaved changes.
  * @return True if the INI file was closed, false if the user has cancelled.
  */
-bool MainWindow::closeIni()
+bool MainWindow::closeIni(const bool &check_unsaved)
 {
-	if (!help_loaded_ && //unless user currently has the help opened which we always allow to close
-	    getSetting("user::inireader::warn_unsaved_ini", "value") == "TRUE") {
+	if (check_unsaved && !help_loaded_ && //unless user currently has the help opened which we always allow to close
+	    getBoolSetting("user::inireader::warn_unsaved_ini")) {
 		/*
 		 * We leave the original INIParser - the one that holds the values like they were
 		 * originally read from an INI file - intact and make a copy of it. The currently
 		 * set values from the GUI are loaded into the copy, and then the two are compared
 		 * for changes. This way we don't display a "settings may be lost" warning if in
 		 * fact nothing has changed, resp. the changes cancelled out.
+		 * Tabs and rows that were never built still have the loaded values, so they are
+		 * kept from the copy instead of being written again.
 		 */
 		INIParser gui_ini = ini_;
-		(void) control_panel_->setIniValuesFromGui(&gui_ini);
+		(void) control_panel_->setIniValuesFromGui(&gui_ini, false);
 		if (ini_ != gui_ini) {
 			QMessageBox msgNotSaved;
 			msgNotSaved.setWindowTitle("Warning ~ " + QCoreApplication::applicationName());
@@ -428,6 +513,7 @@ bool MainWindow::closeIni()
 	file_save_ini_->setEnabled(false);
 	ini_filename_->setText(QString());
 	autoload_->setVisible(false);
+	updateDocumentTab();
 	return true;
 }
 
@@ -441,11 +527,260 @@ void MainWindow::clearGui(const bool &set_default)
 	const bool perform_close = closeIni();
 	if (!perform_close) //user clicked 'cancel'
 		return;
+	Atomic::beginBatchUpdate(); //restyle each panel once
 	getControlPanel()->clearGui(set_default);
+	(void) Atomic::endBatchUpdate();
 	ini_filename_->setText(QString());
 	autoload_->setVisible(false);
 }
 
+/**
+ * @brief Read an application XML, or take it from the already parsed ones if it has not changed.
+ * @details Reading resolves includes and references and validates against the schema. This is
+ * done once per file; opening or appending the same application again only copies the parsed
+ * document, which is cheap compared to reading.
+ * @param[in] path The application's XML file.
+ * @param[out] autoload_ini An INI file name to open automatically if requested in the XML.
+ * @param[out] xml_error XML operations error string.
+ * @return A copy of the application's XML document to build a GUI from.
+ */
+QDomDocument MainWindow::readApplication(const QString &path, QString &autoload_ini, QString &xml_error)
+{
+	const auto cached( app_models_.constFind(path) );
+	if (cached != app_models_.constEnd()) {
+		bool up_to_date = true;
+		for (auto &source : cached->sources) { //the master file or one of its includes may have changed
+			if (QFileInfo( source.first ).lastModified() != source.second) {
+				up_to_date = false;
+				break;
+			}
+		}
+		if (up_to_date) {
+			autoload_ini = cached->autoload_ini;
+			//panels substitute their parameters in the nodes, so each GUI gets its own copy:
+			return cached->xml.cloneNode(true).toDocument();
+		}
+	}
+
+	XMLReader reader;
+	autoload_ini = reader.read(path, xml_error);
+	if (!xml_error.isNull()) //don't keep faulty files so that the errors are shown again
+		return reader.getXml();
+	AppModel model;
+	model.xml = reader.getXml();
+	model.autoload_ini = autoload_ini;
+	for (auto &file : reader.getSourceFiles())
+		model.sources.push_back(qMakePair(file, QFileInfo( file ).lastModified()));
+	app_models_.insert(path, model);
+	return model.xml.cloneNode(true).toDocument();
+}
+
+/**
+ * @brief Open an additional, empty INI document for the current application.
+ * @details All documents share the same panels, so a new document only costs its values.
+ */
+void MainWindow::newIniDocument()
+{
+	storeIniDocument();
+	documents_.emplace_back();
+	documents_.back().ini.setLogger(&logger_);
+	document_tabs_->blockSignals(true);
+	document_tabs_->addTab(tr("Untitled"));
+	document_tabs_->blockSignals(false);
+	loadIniDocument(static_cast<int>(documents_.size()) - 1);
+}
+
+/**
+ * @brief Close an INI document.
+ * @details The user is asked what to do about unsaved changes first. For this, the document is
+ * displayed, unless it is known to have none. The last remaining document is not removed but reset.
+ * @param[in] index Index of the document to close.
+ * @param[in] show_next Display the neighboring document if the displayed one was closed. When
+ * closing several documents this is left to the caller.
+ * @return True if the document was closed, false if the user has cancelled.
+ */
+bool MainWindow::closeIniDocument(const int &index, const bool &show_next)
+{
+	const bool warn_unsaved = !help_loaded_ && getBoolSetting("user::inireader::warn_unsaved_ini");
+	if (index != current_document_ && (!warn_unsaved || !documents_.at(static_cast<size_t>(index)).has_changes)) {
+		removeIniDocument(index); //nothing to ask about
+		return true;
+	}
+	switchIniDocument(index); //the check for unsaved changes works on the displayed document
+	if (!closeIni())
+		return false;
+	if (documents_.size() == 1) {
+		control_panel_->clearGui();
+		return true;
+	}
+	removeIniDocument(index);
+	if (show_next)
+		loadIniDocument(qMin(index, static_cast<int>(documents_.size()) - 1));
+	return true;
+}
+
+/**
+ * @brief Remove an INI document and its tab.
+ * @details If it is the displayed document, the panels keep its values until another one is loaded.
+ * @param[in] index Index of the document to remove.
+ */
+void MainWindow::removeIniDocument(const int &index)
+{
+	documents_.erase(documents_.begin() + index);
+	if (index == current_document_)
+		current_document_ = -1; //nothing to store when switching
+	else if (index < current_document_)
+		--current_document_;
+	document_tabs_->blockSignals(true);
+	document_tabs_->removeTab(index);
+	document_tabs_->blockSignals(false);
+}
+
+/**
+ * @brief Close all INI documents, e. g. before a different application is loaded.
+ * @details Only documents with unsaved changes are displayed to ask the user about them. The panels
+ * of the last document are left as they are since they will be removed anyway.
+ * @return True if all documents were closed, false if the user has cancelled.
+ */
+bool MainWindow::closeAllIniDocuments()
+{
+	if (current_document_ >= 0)
+		storeIniDocument(); //to know if it has changes when it is not displayed anymore
+	while (documents_.size() > 1) {
+		if (!closeIniDocument(static_cast<int>(documents_.size()) - 1, false))
+			return false;
+	}
+	if (current_document_ == 0)
+		return closeIni();
+	const bool warn_unsaved = !help_loaded_ && getBoolSetting("user::inireader::warn_unsaved_ini");
+	if (warn_unsaved && documents_.front().has_changes) {
+		loadIniDocument(0);
+		return closeIni();
+	}
+	current_document_ = 0; //the panels hold a closed document's values, but nothing has to be checked
+	ini_ = documents_.front().ini;
+	return closeIni(false);
+}
+
+/**
+ * @brief Display a different INI document.
+ * @param[in] index Index of the document to display.
+ */
+void MainWindow::switchIniDocument(const int &index)
+{
+	if (index == current_document_ || index < 0 || index >= static_cast<int>(documents_.size()))
+		return;
+	if (current_document_ >= 0)
+		storeIniDocument();
+	loadIniDocument(index);
+}
+
+/**
+ * @brief Remember the displayed document's values so that the panels can be used for another one.
+ * @details The values are taken from the document model, so nothing is read from the panels and
+ * nothing has to be built. Whether there are unsaved changes is checked here as well, so that the
+ * document does not have to be displayed again to find out when it is closed.
+ */
+void MainWindow::storeIniDocument()
+{
+	IniDocument &doc( documents_.at(static_cast<size_t>(current_document_)) );
+	doc.ini = ini_;
+	doc.gui_values.values = DocumentModel::getShared().getValues();
+	doc.gui_values.stored = true;
+	doc.gui_values.shows_defaults = !control_panel_->getClearOnBuild();
+	INIParser gui_ini = ini_; //like in closeIni()
+	(void) control_panel_->setIniValuesFromGui(&gui_ini, false);
+	doc.has_changes = (doc.ini != gui_ini);
+}
+
+/**
+ * @brief Set the panels to the values of an INI document.
+ * @details The panels are reused as they are, only dynamic panels (Replicator, Selector) are
+ * created anew if the document needs them.
+ * @param[in] index Index of the document to display.
+ */
+void MainWindow::loadIniDocument(const int &index)
+{
+	current_document_ = index;
+	const IniDocument &doc( documents_.at(static_cast<size_t>(index)) );
+	ini_ = doc.ini;
+	setUpdatesEnabled(false); //disable painting until done
+	Atomic::beginBatchUpdate(); //setting the values restyles the panels only once
+	expr::ExpressionGraph::getShared().clearValues(); //expressions may refer to keys without panels
+	if (!doc.gui_values.stored) //new document
+		control_panel_->clearGui();
+	else
+		restorePanelValues(doc.gui_values);
+	(void) Atomic::endBatchUpdate();
+	setUpdatesEnabled(true);
+
+	const bool has_file = !ini_.getFilename().isEmpty();
+	ini_filename_->setText(ini_.getFilename());
+	toolbar_save_ini_->setEnabled(has_file);
+	file_save_ini_->setEnabled(has_file);
+	autoload_->setVisible(has_file);
+	document_tabs_->blockSignals(true);
+	document_tabs_->setCurrentIndex(index);
+	document_tabs_->blockSignals(false);
+	updateDocumentTab();
+}
+
+/**
+ * @brief Bind the panels to the stored values of an INI document again.
+ * @details Panels that still exist get their own value back, which does nothing if it is the one
+ * they show already. Children of dynamic panels are created from their keys like when reading an
+ * INI file. Panels that were built while another document was displayed did not exist for this
+ * document, so they are reset like its panels that are not built yet.
+ * @param[in] doc_values The document's stored values.
+ */
+void MainWindow::restorePanelValues(const DocumentValues &doc_values)
+{
+	control_panel_->clearDynamicPanels(); //documents can have different dynamic children
+	control_panel_->setClearOnBuild(!doc_values.shows_defaults);
+	QSet<Atomic *> restored;
+	for (auto &stored : doc_values.values) {
+		Atomic *panel( stored.panel.data() );
+		if (panel != nullptr && (restored.contains(panel) || !Atomic::getPanels(stored.ini_key).contains(panel)))
+			panel = nullptr; //removed child of a dynamic panel (kept for reuse)
+		while (panel == nullptr) { //find a panel for the key that has not been set yet
+			for (auto *candidate : Atomic::getPanels(stored.ini_key, control_panel_)) {
+				if (!restored.contains(candidate)) {
+					panel = candidate;
+					break;
+				}
+			}
+			if (panel == nullptr && !instantiateTemplate(control_panel_, stored.ini_key))
+				break; //the key's dynamic panel is gone, e. g. after appending an application
+		}
+		if (panel == nullptr)
+			continue;
+		QString section, key;
+		panel->setValue(panel->getIniValue(section, key)); //what it displays, cf. Atomic::clear()
+		panel->setValue(stored.value); //only reaches the panel if it's different from the above
+		restored.insert(panel);
+	}
+	for (auto &current : DocumentModel::getShared().getValues()) {
+		if (!current.panel.isNull() && !restored.contains(current.panel.data()))
+			current.panel->clear(doc_values.shows_defaults);
+	}
+}
+
+/**
+ * @brief Show the displayed INI document's file name in its tab.
+ * @details This is called whenever the INI file name changes, so the directory that relative
+ * paths are checked against is updated here as well.
+ */
+void MainWindow::updateDocumentTab()
+{
+	const QString file_name( ini_.getFilename() );
+	document_tabs_->setTabText(current_document_, file_name.isEmpty()? tr("Untitled") :
+	    QFileInfo( file_name ).fileName());
+	document_tabs_->setTabToolTip(current_document_, QDir::toNativeSeparators(file_name));
+	//relative paths in FilePath panels point somewhere else now:
+	FileStatCache::getShared().setBaseDirectory(file_name.isEmpty()? QDir::currentPath() :
+	    QFileInfo( file_name ).absolutePath());
+}
+
 /**
  * @brief Store the main window sizes in the settings XML.
  */
@@ -488,7 +823,7 @@ void MainWindow::createToolbarContextMenu()
 	/* allow user to enable toolbar dragging */
 	auto *fix_toolbar_position = new QAction(tr("Fix toolbar position"), this);
 	fix_toolbar_position->setCheckable(true);
-	fix_toolbar_position->setChecked(getSetting("user::appearance::fix_toolbar_pos", "value") == "TRUE");
+	fix_toolbar_position->setChecked(getBoolSetting("user::appearance::fix_toolbar_pos"));
 	toolbar_context_menu_.addAction(fix_toolbar_position);
 }
 
@@ -534,14 +869,21 @@ void MainWindow::loadHelp(const QString &tab_name, const QString &frame_name)
 		if (QString::compare(key, frame_name, Qt::CaseInsensitive) == 0) {
 			const QString id( section + Cst::sep + key );
 			//this ID must be set in the help XML:
-			auto wid = getMainWindow()->findChild<QGroupBox *>("_primary_" + Atomic::getQtKey(id));
-			QString stylesheet(wid->styleSheet()); //original (to reset with timer)
-			QString stylesheet_copy( stylesheet );
-			wid->setStyleSheet(stylesheet_copy.replace( //flash frame border color
-			    colors::getQColor("frameborder").name(QColor::HexRgb).toLower(),
-			    colors::getQColor("important").name()));
-			QTimer::singleShot(Cst::msg_short_length, this,
-			    [=]{ wid->setStyleSheet(stylesheet); } );
+			const QList<Atomic *> frames( Atomic::getPanels(id) );
+			if (frames.isEmpty())
+				continue;
+			QPointer<QGroupBox> wid( qobject_cast<QGroupBox *>(frames.front()->getPrimaryWidget()) );
+			if (wid.isNull())
+				continue;
+			const auto set_flash = [wid](const bool &flash) { //flash frame border color
+				if (wid.isNull())
+					return;
+				wid->setProperty("flash", flash? "true" : "false");
+				wid->style()->unpolish(wid);
+				wid->style()->polish(wid);
+			};
+			set_flash(true);
+			QTimer::singleShot(Cst::msg_short_length, this, [=]{ set_flash(false); } );
 		}
 	} //endfor panel_list
 	this->raise();
@@ -569,7 +911,7 @@ void MainWindow::openXml(const QString &path, const QString &app_name, const boo
     const bool &is_settings_dialog)
 {
 	if (fresh) {
-		const bool perform_close = closeIni();
+		const bool perform_close = closeAllIniDocuments();
 		if (!perform_close)
 			return;
 		control_panel_->closeSettingsTab();
@@ -582,18 +924,18 @@ void MainWindow::openXml(const QString &path, const QString &app_name, const boo
 	if (QFile::exists(path)) {
 		setStatus(tr("Reading application XML..."), "info", true);
 		refreshStatus();
-		XMLReader xml;
 		QString xml_error = QString();
-		QString autoload_ini( xml.read(path, xml_error) );
+		QString autoload_ini;
+		const QDomDocument xml( readApplication(path, autoload_ini, xml_error) );
 		if (!xml_error.isNull()) {
 			xml_error.chop(1); //trailing \n
 			Error(tr("Errors occured when parsing the XML configuration file"),
 			    tr("File: \"") + QDir::toNativeSeparators(path) + "\"", xml_error);
 		}
 		setStatus("Building GUI...", "info", true);
-		buildGui(xml.getXml());
+		buildGui(xml, !is_settings_dialog); //settings are queried right away
 		setStatus("Ready.", "info", false);
-		control_panel_->getWorkflowPanel()->buildWorkflowPanel(xml.getXml());
+		control_panel_->getWorkflowPanel()->buildWorkflowPanel(xml);
 		if (!autoload_ini.isEmpty()) {
 			if (QFile::exists(autoload_ini))
 				openIni(autoload_ini);
@@ -609,15 +951,13 @@ void MainWindow::openXml(const QString &path, const QString &app_name, const boo
 	}
 
 	//run through all INIs that were saved to be autoloaded and check if it's the application we are opening:
-	for (auto ini_node = global_xml_settings.firstChildElement().firstChildElement("user").firstChildElement(
-	    "autoload").firstChildElement("ini");
-	    !ini_node.isNull(); ini_node = ini_node.nextSiblingElement("ini")) {
-		if (ini_node.attribute("application").toLower() == app_name.toLower()) {
+	for (auto &autoload : getKeyedListSetting("user::autoload", "ini", "application")) {
+		if (autoload.first.toLower() == app_name.toLower()) {
 			autoload_box_->blockSignals(true); //don't re-save the setting we just fetched
 			autoload_box_->setCheckState(Qt::Checked);
 			autoload_box_->setText(tr("autoload this INI for ") + current_application_);
 			autoload_box_->blockSignals(false);
-			openIni(ini_node.text(), true); //TODO: delete if non-existent
+			openIni(autoload.second, true); //TODO: delete if non-existent
 			break;
 		}
 	}
@@ -629,8 +969,11 @@ void MainWindow::openXml(const QString &path, const QString &app_name, const boo
 		return;
 	toolbar_save_ini_as_->setEnabled(true);
 	file_save_ini_as_->setEnabled(true);
+	file_save_ini_resolved_->setEnabled(true);
 	toolbar_open_ini_->setEnabled(true); //toolbar entry
 	file_open_ini_->setEnabled(true); //menu entry
+	file_new_ini_->setEnabled(true);
+	file_close_ini_->setEnabled(true);
 	view_preview_->setEnabled(true);
 	toolbar_preview_->setEnabled(true);
 
@@ -655,21 +998,12 @@ void MainWindow::openXml(const QString &path, const QString &app_name, const boo
  */
 QWidgetList MainWindow::findPanel(QWidget *parent, const Section &section, const KeyValue &keyval)
 {
-	QWidgetList panels;
 	//first, check if there is a panel for it loaded and available:
-	panels = findSimplePanel(parent, section, keyval);
-	int panel_count = parent->findChildren<Atomic *>().count();
-	//if not found, check if one of our Replicators can create it:
-	if (panels.isEmpty())
-		panels = prepareReplicator(parent, section, keyval);
-	//if still not found, check if one of our Selectors can create it:
-	if (panels.isEmpty())
-		panels = prepareSelector(parent, section, keyval);
-	//TODO: For the current MeteoIO XML the order is important here so that a TIME filter
-	//does not show up twice (because both the normal and time filter's panel fit the pattern).
-	//Cleaning up here would also increase performance.
-	if (parent->findChildren<Atomic *>().count() != panel_count) //new elements were created
-		return findPanel(parent, section, keyval); //recursion through Replicators that create Selectors that...
+	QWidgetList panels( findSimplePanel(parent, section, keyval) );
+	//if not found, check if one of our Replicators or Selectors can create it:
+	const QString id( section.getName() + Cst::sep + keyval.getKey() );
+	while (panels.isEmpty() && instantiateTemplate(parent, id))
+		panels = findSimplePanel(parent, section, keyval); //Replicators that create Selectors that...
 	return panels; //no more suitable dynamic panels found
 }
 
@@ -686,100 +1020,102 @@ QWidgetList MainWindow::findSimplePanel(QWidget *parent, const Section &section,
 {
 	QString id(section.getName() + Cst::sep + keyval.getKey());
 	/* simple, not nested, keys */
-	return parent->findChildren<QWidget *>(Atomic::getQtKey(id));
+	QWidgetList panels;
+	for (auto *panel : Atomic::getPanels(id, parent))
+		panels.push_back(panel);
+	return panels;
 }
 
 /**
- * @brief Find a Selector in our GUI that could handle a given INI key.
- * @details This function looks for Selectors handling keys like "%::COPY". If one is found,
- * it requests the Selector to create a new panel for the key which will then be available
- * to the parent function that is currently looking for a suitable panel for the INI key.
+ * @brief Let a Replicator or Selector create panels that could handle a given INI key.
+ * @details The template keys of all dynamic panels are kept in a prefix tree, so the panel
+ * whose template fits the key best is found in a single pass over the key. If one is found,
+ * it is requested to create a new panel for the key (which may in turn be a dynamic panel).
  * @param[in] parent The parent panel or window to search.
- * @param[in] section Section to find.
- * @param[in] keyval Key/value pair to find.
- * @return A list of panels for the INI key including the possibly newly created ones.
+ * @param[in] ini_key The INI key including the section.
+ * @return True if new panels were created.
  */
-QWidgetList MainWindow::prepareSelector(QWidget *parent, const Section &section, const KeyValue &keyval)
+bool MainWindow::instantiateTemplate(QWidget *parent, const QString &ini_key)
 {
-	QString id(section.getName() + Cst::sep + keyval.getKey());
-	//INI key as it would be given in the file, i. e. with the parameters in place instead of the Selector's %:
-	const QString regex_selector("^" + section.getName() + Cst::sep + R"(([\w\*\-\.]+)()" + Cst::sep + R"()(\w+?)([0-9]*$))");
-	const QRegularExpression rex(regex_selector);
-	const QRegularExpressionMatch matches = rex.match(id);
-
-	if (matches.captured(0) == id) { //it could be from a selector with template children
-		static const size_t idx_parameter = 1;
-		static const size_t idx_keyname = 3;
-		static const size_t idx_optional_number = 4;
-		const QString parameter(matches.captured(idx_parameter));
-		const QString key_name(matches.captured(idx_keyname));
-		const QString number(matches.captured(idx_optional_number));
-		//this would be the ID given in an XML, i. e. with a "%" staing for a parameter:
-		const QString gui_id = section.getName() + Cst::sep + "%" + Cst::sep + key_name + (number.isEmpty()? "" : "#");
-
-		//try to find Selector:
-		QList<Selector *> selector_list = parent->findChildren<Selector *>(Atomic::getQtKey(gui_id));
-		for (int ii = 0; ii < selector_list.size(); ++ii)
-			selector_list.at(ii)->setProperty("ini_value", parameter); //cf. notes in prepareReplicator
-		//now all the right child widgets should exist and we can try to find again:
-		const QString key_id = section.getName() + Cst::sep + keyval.getKey(); //the one we were originally looking for
-
-		return parent->findChildren<QWidget *>(Atomic::getQtKey(key_id));
+	for (auto &match : Atomic::getTemplates(ini_key)) {
+		if (!parent->isAncestorOf(match.panel))
+			continue;
+		/*
+		 * A Replicator or Selector can't normally be accessed via INI keys, because there is no
+		 * standalone XML code for it. It always occurs together with child panels, and those are
+		 * the ones that will be sought by the INI parser to set values. Therefore we can use the
+		 * panel's setValue() to tell it to create its panel (the number for a
+		 * Replicator, the parameter for a Selector), thus creating the necessary child panels.
+		 */
+		const unsigned int registry_revision = Atomic::getRegistryRevision();
+		match.panel->setValue(match.token);
+		return (Atomic::getRegistryRevision() != registry_revision);
 	}
-	return QWidgetList();
+	return false; //no suitable dynamic panel found
 }
 
 /**
- * @brief Find a Replicator in our GUI that could handle a given INI key.
- * @details This function looks for Replicators handling keys like "STATION#". If one is found,
- * it requests the Replicator to create a new panel for the key which will then be available
- * to the parent function that is currently looking for a suitable panel for the INI key.
- * @param[in] parent The parent panel or window to search.
- * @param[in] section Section to find.
- * @param[in] keyval Key/value pair to find.
- * @return A list of panels for the INI key including the possibly newly created ones.
+ * @brief Create the dynamic panels needed for all keys of a section at once.
+ * @details Each round requests every needed child panel once from the fitting Replicators and
+ * Selectors. Rounds are repeated as long as new dynamic panels appear (Replicators that create
+ * Selectors that...).
+ * @param[in] parent The section's tab.
+ * @param[in] section The INI section to prepare the panels for.
  */
-QWidgetList MainWindow::prepareReplicator(QWidget *parent, const Section &section, const KeyValue &keyval)
+void MainWindow::createDynamicPanels(QWidget *parent, const Section &section)
 {
-	QString id(section.getName() + Cst::sep + keyval.getKey());
-	//the key how it would look in an INI file:
-	const QString regex_selector("^" + section.getName() + Cst::sep +
-	    R"(([\w\.]+)" + Cst::sep + R"()*(\w*?)(?=\d)(\d*)$)");
-	const QRegularExpression rex(regex_selector);
-	const QRegularExpressionMatch matches = rex.match(id);
+	QStringList pending_keys;
+	for (auto &keyval : section.getKeyValueList()) {
+		const QString id( section.getName() + Cst::sep + keyval.second.getKey() );
+		if (Atomic::getPanels(id, parent).isEmpty())
+			pending_keys.push_back(id);
+	}
 
-	if (matches.captured(0) == id) { //it's from a replicator with template children
-		/*
-		 * If we arrive here, we try to find the panel for an INI key that could belong
-		 * to the child of a Replicator, e. g. "INPUT::STATION1" or "FILTERS::TA::FILTER1".
-		 * We extract the name the Replicator would have (number to "#") and try finding it.
-		 */
-		static const size_t idx_parameter = 1;
-		static const size_t idx_key = 2;
-		static const size_t idx_number = 3;
-		QString parameter(matches.captured(idx_parameter)); //has trailing "::" if existent
-		const QString key(matches.captured(idx_key));
-		const QString number(matches.captured(idx_number));
-		//the key how it would look in an XML:
-		QString gui_id = section.getName() + Cst::sep + parameter + key + "#"; //Replicator's name
+	while (!pending_keys.isEmpty()) {
+		QList<QPair<QPointer<Atomic>, QString>> requests; //dynamic panel and value to set, each once
+		QSet<QPair<Atomic *, QString>> requested;
+		for (auto &id : pending_keys) {
+			for (auto &match : Atomic::getTemplates(id)) {
+				if (!parent->isAncestorOf(match.panel))
+					continue;
+				const QPair<Atomic *, QString> request_id( match.panel, match.token );
+				if (!requested.contains(request_id)) {
+					requested.insert(request_id);
+					requests.push_back(qMakePair(QPointer<Atomic>(match.panel), match.token));
+				}
+				break; //only the best fitting template creates panels
+			}
+		}
+		const unsigned int registry_revision = Atomic::getRegistryRevision();
+		QList<QPair<QPointer<Replicator>, QList<int>>> replications; //all numbers per Replicator
+		QHash<Replicator *, int> replication_index;
+		for (auto &request : requests) {
+			if (request.first.isNull())
+				continue;
+			if (auto *replicator = qobject_cast<Replicator *>(request.first.data())) {
+				if (!replication_index.contains(replicator)) {
+					replication_index.insert(replicator, replications.size());
+					replications.push_back(qMakePair(QPointer<Replicator>(replicator), QList<int>()));
+				}
+				replications[replication_index.value(replicator)].second.push_back(request.second.toInt());
+			} else { //cf. notes in instantiateTemplate()
+				request.first->setValue(request.second);
+			}
+		}
+		for (auto &replication : replications) { //create numbered items in one go and in order
+			if (!replication.first.isNull())
+				replication.first->replicateAll(replication.second);
+		}
+		if (Atomic::getRegistryRevision() == registry_revision) //nothing new - leave the rest to findPanel()
+			break;
 
-		/*
-		 * A replicator can't normally be accessed via INI keys, because there is no
-		 * standalone XML code for it. It always occurs together with child panels,
-		 * and those are the ones that will be sought by the INI parser to set values.
-		 * Therefore we can use the "ini_value" property listener for a Replicator to
-		 * tell it to replicate its panel, thus creating the necessary child panels.
-		 */
-		QList<Replicator *> replicator_list = parent-> //try to find replicator:
-		    findChildren<Replicator *>(Atomic::getQtKey(gui_id));
-		for (int ii = 0; ii < replicator_list.count(); ++ii)
-			replicator_list.at(ii)->setProperty("ini_value", number);
-		//now all the right child panels should exist and we can try to find again:
-		const QString key_id(section.getName() + Cst::sep + keyval.getKey()); //the one we were originally looking for
-		return parent->findChildren<QWidget *>(Atomic::getQtKey(key_id));
-	} //endif has match
-
-	return QWidgetList(); //no suitable Replicator found
+		QStringList still_pending;
+		for (auto &id : pending_keys) {
+			if (Atomic::getPanels(id, parent).isEmpty())
+				still_pending.push_back(id);
+		}
+		pending_keys.swap(still_pending);
+	}
 }
 
 /**
@@ -806,6 +1142,21 @@ void MainWindow::createMenu()
 	menu_file->addAction(file_save_ini_as_);
 	file_save_ini_as_->setEnabled(false);
 	connect(file_save_ini_as_, &QAction::triggered, this, [=]{ toolbarClick("save_ini_as"); });
+	file_save_ini_resolved_ = new QAction(tr("Save INI file with &resolved expressions..."), menu_file);
+	menu_file->addAction(file_save_ini_resolved_);
+	file_save_ini_resolved_->setEnabled(false);
+	connect(file_save_ini_resolved_, &QAction::triggered, this, &MainWindow::saveIniResolved);
+	menu_file->addSeparator();
+	file_new_ini_ = new QAction(getIcon("document-new"), tr("&New INI document"), menu_file);
+	file_new_ini_->setShortcut(QKeySequence::New);
+	menu_file->addAction(file_new_ini_);
+	file_new_ini_->setEnabled(false); //enable with loaded application
+	connect(file_new_ini_, &QAction::triggered, this, &MainWindow::newIniDocument);
+	file_close_ini_ = new QAction(getIcon("document-close"), tr("&Close INI document"), menu_file);
+	file_close_ini_->setShortcut(QKeySequence::Close);
+	menu_file->addAction(file_close_ini_);
+	file_close_ini_->setEnabled(false);
+	connect(file_close_ini_, &QAction::triggered, this, [=]{ (void) closeIniDocument(current_document_); });
 	menu_file->addSeparator();
 	auto *file_quit_ = new QAction(getIcon("application-exit"), tr("&Exit"), menu_file);
 	file_quit_->setShortcut(QKeySequence::Quit);
@@ -1059,7 +1410,8 @@ void MainWindow::quitProgram()
  */
 void MainWindow::resetGui()
 {
-	toolbarClick("clear_gui");
+	if (!closeAllIniDocuments()) //user clicked 'cancel'
+		return;
 	control_panel_->clearGuiElements();
 	control_panel_->displayInfo();
 	help_loaded_ = false;
@@ -1079,6 +1431,9 @@ void MainWindow::resetGui()
 	file_open_ini_->setEnabled(false);
 	file_save_ini_->setEnabled(false);
 	file_save_ini_as_->setEnabled(false);
+	file_save_ini_resolved_->setEnabled(false);
+	file_new_ini_->setEnabled(false);
+	file_close_ini_->setEnabled(false);
 	gui_reset_->setEnabled(false);
 	gui_clear_->setEnabled(false);
 	view_preview_->setEnabled(false);
@@ -1094,6 +1449,18 @@ void MainWindow::viewLogger()
 	logger_.raise(); //bring to front
 }
 
+/**
+ * @brief Event listener for changes of the window's state.
+ * @details If the system's palette changes the dark mode may switch (if it is set to AUTO).
+ * @param[in] event The received change event.
+ */
+void MainWindow::changeEvent(QEvent *event)
+{
+	if (event->type() == QEvent::PaletteChange)
+		colors::invalidateTheme();
+	QMainWindow::changeEvent(event);
+}
+
 /**
  * @brief Event listener for when the program is closed.
  * @details This function checks whether there are unsaved changes before exiting the program,
@@ -1102,7 +1469,7 @@ void MainWindow::viewLogger()
  */
 void MainWindow::closeEvent(QCloseEvent *event)
 {
-	const bool perform_close = closeIni();
+	const bool perform_close = closeAllIniDocuments();
 	if (perform_close)
 		event->accept();
 	else
@@ -1211,31 +1578,31 @@ void MainWindow::toolbarClick(const QString &function)
 /**
  * @brief Event listener for when the 'autoload' checkbox is clicked.
  * @details This function sets settings for the INI files to be automatically loaded for certain XMLs.
- * They are saved when the program quits.
+ * They are written to the settings file shortly after.
  * @param[in] state The checkbox state (checked/unchecked).
  */
 void MainWindow::onAutoloadCheck(const int &state)
 {
-	//Run through <ini> tags in appropriate settings file section and look for the current
-	//application. If it is found, when the checkbox is checked it will be set to the current
-	//INI file. If the box is unchecked the entry is deleted:
-	QDomNode autoload_node( global_xml_settings.firstChildElement().firstChildElement("user").firstChildElement("autoload") );
-	for (auto ini = autoload_node.firstChildElement("ini"); !ini.isNull(); ini = ini.nextSiblingElement("ini")) {
-		if (ini.attribute("application").toLower() == current_application_.toLower()) {
+	//Run through the autoload INIs and look for the current application. If it is found, when
+	//the checkbox is checked it will be set to the current INI file. If the box is unchecked the
+	//entry is deleted:
+	QList<QPair<QString, QString>> autoloads( getKeyedListSetting("user::autoload", "ini", "application") );
+	bool found = false;
+	for (auto it = autoloads.begin(); it != autoloads.end(); ++it) {
+		if (it->first.toLower() == current_application_.toLower()) {
 			if (state == Qt::Checked)
-				ini.firstChild().setNodeValue(ini_filename_->text());
+				it->second = ini_filename_->text();
 			else
-				ini.parentNode().removeChild(ini);
-			return;
+				autoloads.erase(it);
+			found = true;
+			break;
 		}
 	}
 
 	//not found - create new settings node if user is enabling:
-	if (state == Qt::Checked) {
-		QDomNode ini( autoload_node.appendChild(global_xml_settings.createElement("ini")) );
-		ini.toElement().setAttribute("application", current_application_);
-		ini.appendChild(global_xml_settings.createTextNode(ini_filename_->text()));
-	}
+	if (!found && state == Qt::Checked)
+		autoloads.push_back(qMakePair(current_application_, ini_filename_->text()));
+	setKeyedListSetting("user::autoload", "ini", "application", autoloads);
 }
 
 /**
@@ -28,28 +28,55 @@
 #include "Logger.h"
 #include "src/gui/MainPanel.h"
 #include "src/gui/PreviewWindow.h"
+#include "src/gui_elements/DocumentModel.h"
 #include "src/main/constants.h"
 #include "src/main/INIParser.h"
 
 #include <QAction>
 #include <QCheckBox>
 #include <QCommandLineParser>
+#include <QDateTime>
+#include <QHash>
 #include <QKeyEvent>
 #include <QIcon>
 #include <QLabel>
 #include <QList>
 #include <QMainWindow>
+#include <QPair>
 #include <QString>
 #include <QTabBar>
 #include <QTimer>
 #include <QtXml>
 #include <QWidgetList>
 
+#include <vector>
+
 class MouseEventFilter : public QObject { //handles all mouse clicks in the main window
 	public:
 		bool eventFilter(QObject *object, QEvent *event) override;
 };
 
+/**
+ * @struct IniDocument
+ * @brief An INI file that is open for the current application.
+ * @details All documents share the same panels, only the displayed one has its values in the GUI.
+ */
+struct IniDocument {
+	INIParser ini; //the file as it was read, to detect unsaved changes
+	DocumentValues gui_values; //the panels' values while another document is displayed
+	bool has_changes = false; //the stored values differ from the file
+};
+
+/**
+ * @struct AppModel
+ * @brief A parsed application XML that is kept to build further GUIs from.
+ */
+struct AppModel {
+	QDomDocument xml; //never built from directly since panels modify their nodes
+	QString autoload_ini;
+	QList<QPair<QString, QDateTime>> sources; //master and include files with modification times
+};
+
 class MainWindow : public QMainWindow {
 	Q_OBJECT //Qt macro to make code g++ ready
 
@@ -62,7 +89,7 @@ class MainWindow : public QMainWindow {
 		MainWindow(MainWindow&&) = delete;
 		MainWindow& operator=(MainWindow&&) = delete;
 		
-		void buildGui(const QDomDocument &xml);
+		void buildGui(const QDomDocument &xml, const bool &lazy_tabs = false);
 		MainPanel * getControlPanel() const { return control_panel_; }
 		QList<Atomic *> getPanelsForKey(const QString &ini_key);
 		void setStatus(const QString &message, const QString &color = "normal", const bool &status_light = false,
@@ -85,6 +112,7 @@ class MainWindow : public QMainWindow {
 		void viewLogger();
 
 	protected:
+		void changeEvent(QEvent *event) override;
 		void closeEvent(QCloseEvent* event) override;
 		void keyPressEvent(QKeyEvent *event) override;
 
@@ -94,13 +122,25 @@ class MainWindow : public QMainWindow {
 		void createStatusbar();
 		QWidgetList findPanel(QWidget *parent, const Section &section, const KeyValue &keyval);
 		QWidgetList findSimplePanel(QWidget *parent, const Section &section, const KeyValue &keyval);
-		QWidgetList prepareSelector(QWidget *parent, const Section &section, const KeyValue &keyval);
-		QWidgetList prepareReplicator(QWidget *parent, const Section &section, const KeyValue &keyval);
-		void saveIni(const QString &filename = QString());
+		bool instantiateTemplate(QWidget *parent, const QString &ini_key);
+		void createDynamicPanels(QWidget *parent, const Section &section);
+		void saveIni(const QString &filename = QString(), const bool &resolve_expressions = false);
 		void saveIniAs();
+		void saveIniResolved();
+		QString selectIniSaveFile(const QString &caption);
 		void openIni();
-		bool closeIni();
+		bool closeIni(const bool &check_unsaved = true);
 		void clearGui(const bool &set_default = true);
+		QDomDocument readApplication(const QString &path, QString &autoload_ini, QString &xml_error);
+		void newIniDocument();
+		bool closeIniDocument(const int &index, const bool &show_next = true);
+		void removeIniDocument(const int &index);
+		bool closeAllIniDocuments();
+		void switchIniDocument(const int &index);
+		void storeIniDocument();
+		void loadIniDocument(const int &index);
+		void restorePanelValues(const DocumentValues &doc_values);
+		void updateDocumentTab();
 		void setWindowSizeSettings();
 		void setSplitterSizeSettings();
 		void createToolbarContextMenu();
@@ -114,6 +154,9 @@ class MainWindow : public QMainWindow {
 		QAction *file_open_ini_ = nullptr; //menu items
 		QAction *file_save_ini_ = nullptr;
 		QAction *file_save_ini_as_ = nullptr;
+		QAction *file_save_ini_resolved_ = nullptr;
+		QAction *file_new_ini_ = nullptr;
+		QAction *file_close_ini_ = nullptr;
 		QAction *gui_reset_ = nullptr;
 		QAction *gui_close_all_ = nullptr;
 		QAction *gui_clear_ = nullptr;
@@ -123,7 +166,11 @@ class MainWindow : public QMainWindow {
 		MainPanel *control_panel_ = nullptr;
 		PreviewWindow *preview_ = nullptr;
 		Logger logger_;
-		INIParser ini_;
+		INIParser ini_; //the displayed document's INI file
+		QTabBar *document_tabs_ = nullptr;
+		std::vector<IniDocument> documents_; //all open INI documents
+		int current_document_ = 0; //-1 while the panels hold the values of a closed document
+		QHash<QString, AppModel> app_models_; //parsed application XMLs by file name
 		QString xml_settings_filename_; //OS-specifc path to the settings file
 		QLabel *status_label_ = nullptr;
 		QLabel *status_icon_ = nullptr;
@@ -18,6 +18,7 @@
 
 #include "PreviewWindow.h"
 #include "src/gui_elements/Atomic.h"
+#include "src/gui_elements/DocumentModel.h"
 #include "src/main/colors.h"
 #include "src/main/common.h"
 #include "src/main/os.h"
@@ -95,7 +96,7 @@ SyntaxHighlighter::SyntaxHighlighter(QTextDocument *textdoc) : QSyntaxHighlighte
 
 	/* unknown sections */
 	QTextCharFormat format_section;
-	format_section.setForeground(colors::getQColor("syntax_unknown_section"));
+	format_section.setForeground(colors::getQColor(colors::Color::syntax_unknown_section));
 	format_section.setFontWeight(QFont::Bold);
 	rule.pattern = QRegularExpression(R"(.*\)" + Cst::section_open + R"(.*\)" + Cst::section_close + R"(.*)");
 	rule.format = format_section;
@@ -103,7 +104,7 @@ SyntaxHighlighter::SyntaxHighlighter(QTextDocument *textdoc) : QSyntaxHighlighte
 
 	/* unknown keys */
 	QTextCharFormat format_unknown_key;
-	format_unknown_key.setForeground(colors::getQColor("syntax_unknown_key"));
+	format_unknown_key.setForeground(colors::getQColor(colors::Color::syntax_unknown_key));
 	rule.pattern = QRegularExpression(R"(^\s*[\w|:|*]+(?=\s*=))"); //TODO: only :: but not :
 	//TODO: collect and unify all regex handling (e. g. use the same here as in INIParser)
 	rule.format = format_unknown_key;
@@ -111,7 +112,7 @@ SyntaxHighlighter::SyntaxHighlighter(QTextDocument *textdoc) : QSyntaxHighlighte
 
 	/* INI values */
 	QTextCharFormat format_value;
-	format_value.setForeground(colors::getQColor("syntax_value"));
+	format_value.setForeground(colors::getQColor(colors::Color::syntax_value));
 	rule.pattern = QRegularExpression(R"((?<=\=).*)");
 	rule.format = format_value;
 	rules_.append(rule);
@@ -119,17 +120,23 @@ SyntaxHighlighter::SyntaxHighlighter(QTextDocument *textdoc) : QSyntaxHighlighte
 
 	/* populate highlighter with known sections and keys */
 	QTextCharFormat format_known_key;
-	format_known_key.setForeground(colors::getQColor("syntax_known_key"));
+	format_known_key.setForeground(colors::getQColor(colors::Color::syntax_known_key));
 	QTextCharFormat format_known_section;
-	format_known_section.setForeground(colors::getQColor("syntax_known_section"));
+	format_known_section.setForeground(colors::getQColor(colors::Color::syntax_known_section));
 	format_known_section.setFontWeight(QFont::Bold);
 
+	QList<QPair<QString, QString>> known_keys( DocumentModel::getShared().getUnbuiltKeys() ); //from the XML
 	const QList<Atomic *> panel_list( getMainWindow()->findChildren<Atomic *>() );
 	for (auto &panel : panel_list) {
 		if (panel->property("no_ini").toBool()) //e. g. Groups / frames
 			continue;
 		QString section, key;
 		(void) panel->getIniValue(section, key);
+		known_keys.push_back(qMakePair(section, key));
+	}
+	for (auto &known_key : known_keys) {
+		const QString &section( known_key.first );
+		QString key( known_key.second );
 		key.replace("*", "\\*");
 		rule.pattern = QRegularExpression("\\" + Cst::section_open + section + "\\" +
 		    Cst::section_close, QRegularExpression::CaseInsensitiveOption); //TODO: escape only if needed for the set char
@@ -142,7 +149,7 @@ SyntaxHighlighter::SyntaxHighlighter(QTextDocument *textdoc) : QSyntaxHighlighte
 
 	/* comments */
 	QTextCharFormat format_block_comment;
-	format_block_comment.setForeground(colors::getQColor("syntax_comment"));
+	format_block_comment.setForeground(colors::getQColor(colors::Color::syntax_comment));
 	rule.pattern = QRegularExpression(R"(^\s*[#;].*)");
 	rule.format = format_block_comment;
 	rules_.append(rule);
@@ -151,7 +158,7 @@ SyntaxHighlighter::SyntaxHighlighter(QTextDocument *textdoc) : QSyntaxHighlighte
 
 	/* coordinates */
 	QTextCharFormat format_coordinate;
-	format_coordinate.setForeground(colors::getQColor("coordinate"));
+	format_coordinate.setForeground(colors::getQColor(colors::Color::coordinate));
  	rule.pattern = QRegularExpression(R"((latlon|xy)\s*\(([-\d\.]+)(?:,)\s*([-\d\.]+)((?:,)\s*([-\d\.]+))?\))");
 	rule.format = format_coordinate;
 	rules_.append(rule);
@@ -229,10 +236,10 @@ void PreviewWindow::addIniTab(const QString& infile)
 		preview_ini_.parseFile(infile); //load INI from file system
 
 	/* text box for the current INI */
-	const bool setMonospace = (getSetting("user::preview::mono_font", "value") == "TRUE");
+	const bool setMonospace = getBoolSetting("user::preview::mono_font");
 	auto *preview_editor( new PreviewEdit(setMonospace) );
 	preview_editor->installEventFilter(editor_key_filter_);
-	preview_editor->setStyleSheet("QPlainTextEdit {background-color: " + colors::getQColor("syntax_background").name() + "; color: " + colors::getQColor("syntax_invalid").name() + "}");
+	preview_editor->setStyleSheet("QPlainTextEdit {background-color: " + colors::getQColor(colors::Color::syntax_background).name() + "; color: " + colors::getQColor(colors::Color::syntax_invalid).name() + "}");
 
 	highlighter_ = new SyntaxHighlighter(preview_editor->document());
 
@@ -270,7 +277,7 @@ void PreviewWindow::addIniTab(const QString& infile)
 	file_tabs_->setCurrentIndex(file_tabs_->count() - 1); //switch to new tab
 	connect(preview_editor, &QPlainTextEdit::textChanged, this, [=]{ textChanged(file_tabs_->count() - 1); });
 
-	onShowWhitespacesMenuClick((getSetting("user::preview::show_ws", "value") == "TRUE"));
+	onShowWhitespacesMenuClick(getBoolSetting("user::preview::show_ws"));
 
 } //TODO: tab completion for INI keys
 
@@ -290,7 +297,7 @@ void PreviewWindow::closeEvent(QCloseEvent *event)
 		}
 	}
 	if (has_unsaved_changes &&
-	    getSetting("user::inireader::warn_unsaved_ini", "value") == "TRUE") { //at least one tab has unsaved changes
+	    getBoolSetting("user::inireader::warn_unsaved_ini")) { //at least one tab has unsaved changes
 		const int cancel = warnOnUnsavedIni();
 		if (cancel == QMessageBox::Cancel) {
 			event->ignore();
@@ -351,7 +358,7 @@ void PreviewWindow::closeTab(int index)
 	//Check for unsaved changes. Note that changes that cancel out leaving the INI file
 	//unaltered will still trigger the warning (unlike the GUI).
 	if (file_tabs_->tabText(index).endsWith("*") &&
-	    getSetting("user::inireader::warn_unsaved_ini", "value") == "TRUE") { //not saved yet
+	    getBoolSetting("user::inireader::warn_unsaved_ini")) { //not saved yet
 		const int cancel = warnOnUnsavedIni();
 		if (cancel == QMessageBox::Cancel)
 			return;
@@ -613,7 +620,7 @@ void PreviewWindow::createMenu()
 	QMenu *menu_view = this->menuBar()->addMenu(tr("&View"));
 	auto *view_hidden_chars = new QAction(tr("Show &whitespaces"), menu_view);
 	view_hidden_chars->setCheckable(true);
-	if (getSetting("user::preview::show_ws", "value") == "TRUE")
+	if (getBoolSetting("user::preview::show_ws"))
 		view_hidden_chars->setChecked(true);
 	connect (view_hidden_chars, &QAction::triggered, this,
 	    [=]{ onShowWhitespacesMenuClick(view_hidden_chars->isChecked()); } );
@@ -1254,7 +1261,7 @@ void PreviewWindow::onFindTextChanged(const QString &text)
 		find_text_->setStyleSheet(QString( ));
 		//TODO: find next on Enter
 	else
-		find_text_->setStyleSheet("QLineEdit {color: " + colors::getQColor("warning").name() + "}");
+		find_text_->setStyleSheet("QLineEdit {color: " + colors::getQColor(colors::Color::warning).name() + "}");
 }
 
 /**
@@ -18,7 +18,6 @@
 
 #include "WorkflowPanel.h"
 #include "src/gui/PathView.h"
-#include "src/gui_elements/Atomic.h" //for getQtKey()
 #include "src/main/colors.h"
 #include "src/main/common.h"
 #include "src/main/constants.h"
@@ -58,8 +57,9 @@ WorkflowPanel::WorkflowPanel(QWidget *parent) : QWidget(parent)
 	connect(workflow_container_, &QToolBox::currentChanged, this, &WorkflowPanel::toolboxClicked);
 
 	//add a list view for applications, one for simulations, and one for INI files:
-	applications_ = new ApplicationsView(tr("Applications"));
-	simulations_ = new ApplicationsView(tr("Simulations"));
+	icon_cache_ = new IconCache(this); //shared by both lists
+	applications_ = new ApplicationsView(tr("Applications"), icon_cache_);
+	simulations_ = new ApplicationsView(tr("Simulations"), icon_cache_);
 	filesystem_ = new IniFolderView;
 	auto *path_label = filesystem_->getInfoLabel();
 	path_label->setText(tr("Open an application or simulation before opening INI files."));
@@ -76,6 +76,9 @@ WorkflowPanel::WorkflowPanel(QWidget *parent) : QWidget(parent)
 	layout->addWidget(workflow_container_);
 	this->setLayout(layout);
 
+	app_scanner_ = new AppScanner(this); //searches in the background and watches for changes
+	connect(app_scanner_, &AppScanner::directoriesFound, this, &WorkflowPanel::onAppDirectoriesFound);
+	connect(app_scanner_, &AppScanner::scanFinished, this, &WorkflowPanel::onAppScanFinished);
 	scanFoldersForApps(); //perform the search for XMLs that are an application or simulation
 }
 
@@ -108,20 +111,52 @@ void WorkflowPanel::buildWorkflowPanel(const QDomDocument &xml)
 
 /**
  * @brief Iterate through a number of folders and look for applicable XML files.
+ * @details The search runs in the background and the lists are populated when it's done.
  */
 void WorkflowPanel::scanFoldersForApps()
 {
 	topStatus(tr("Scanning for applications and simulations..."));
-	bool applications_found, simulations_found;
-	readAppsFromDirs(applications_found, simulations_found); //populate the applications and simulations lists
-	topStatus(tr("Done scanning, ") +
-	    ((applications_found || simulations_found)? tr("items") : tr("nothing")) + tr(" found."));
-	if (!applications_found)
-		applications_->addInfoSeparator(tr(
-		    "No applications found. Please check the help section \"Applicatons\" to obtain the necessary files."), 0);
-	if (!simulations_found) //no files containing "<inishell_config simulation=..." found
-		simulations_->addInfoSeparator(tr(
-		    "No simulations found. Please check the help section \"Simulations\" to set up your simulations."), 0);
+	app_scanner_->scan(getSearchDirs()); //hardcoded and user set directories
+}
+
+/**
+ * @brief Event listener for directories that were searched for applications and simulations.
+ * @details Results arrive while the search is still running. Only the directories that were
+ * (re-)scanned are updated in the lists.
+ * @param[in] result The XML files that were found.
+ */
+void WorkflowPanel::onAppDirectoriesFound(const AppScanResult &result)
+{
+	for (auto &app_dir : result.directories) {
+		applications_->setDirectory(app_dir, "application");
+		simulations_->setDirectory(app_dir, "simulation");
+	}
+	for (auto &error : result.errors)
+		topLog(error, "error");
+}
+
+/**
+ * @brief Event listener for a finished background search for applications and simulations.
+ * @details Directories that have disappeared are removed from the lists.
+ * @param[in] result All XML files that were found.
+ */
+void WorkflowPanel::onAppScanFinished(const AppScanResult &result)
+{
+	for (auto &dir : result.removed_directories) {
+		applications_->removeDirectory(dir);
+		simulations_->removeDirectory(dir);
+	}
+
+	//display an info when empty:
+	applications_->setEmptyInfo(tr(
+	    "No applications found. Please check the help section \"Applicatons\" to obtain the necessary files."));
+	//no files containing "<inishell_config simulation=..." found:
+	simulations_->setEmptyInfo(tr(
+	    "No simulations found. Please check the help section \"Simulations\" to set up your simulations."));
+	if (result.full_scan) {
+		const bool found_items = (applications_->count() > 1 || simulations_->count() > 1); //separator + item
+		topStatus(tr("Done scanning, ") + (found_items? tr("items") : tr("nothing")) + tr(" found."));
+	}
 }
 
 /**
@@ -133,6 +168,7 @@ void WorkflowPanel::clearXmlPanels()
 		if (workflow_container_->widget(ii)->property("from_xml").toBool())
 			workflow_container_->widget(ii)->deleteLater();
 	}
+	workflow_elements_.clear();
 }
 
 /**
@@ -281,79 +317,26 @@ QWidget * WorkflowPanel::workflowElementFactory(QDomElement &item, const QString
 		if (!item.attribute("path").isNull())
 			static_cast<PathView *>(element)->setPath(item.attribute("path"));
 	}
-	if (element) //give the element a unique internal ID
-		element->setObjectName("_workflow_" + Atomic::getQtKey(id));
+	if (element && !id.isEmpty()) //make the element available to commands referring to its ID
+		workflow_elements_.insert(id.toLower(), element);
 	return element;
 }
 
 /**
- * @brief Scan a list of directories for suitable XML files to load.
- * @details This function runs through files of numerous directories and looks for the
- * "<inishell_config...>" header. It discerns between applications and simulations and populates
- * the corresponding list view in the workflow panel.
- * @param[out] applications_found True if at least one application was found.
- * @param[out] simulations_found True if at least one simulation was found.
+ * @brief Find the workflow elements with a certain ID.
+ * @param[in] id The element ID as given in the XML (case insensitive).
+ * @param[in] parent If given, only elements within this widget are returned.
+ * @return All matching elements that still exist.
  */
-void WorkflowPanel::readAppsFromDirs(bool &applications_found, bool &simulations_found)
+QWidgetList WorkflowPanel::findWorkflowElements(const QString &id, const QWidget *parent) const
 {
-	static const QStringList filters = {"*.xml", "*.XML"};
-	applications_->clear();
-	simulations_->clear();
-
-	const QStringList directory_list( getSearchDirs() ); //hardcoded and user set directories
-	for (auto &directory : directory_list) {
-		if (directory.isEmpty())
-			continue;
-
-		//display only (XML) files:
-		const QStringList apps( QDir(directory).entryList(filters, QDir::Files) );
-		//we check how much individual directories contribute for appropriate folder info display:
-		const int count_before_applications = applications_->count();
-		const int count_before_simulations = simulations_->count();
-
-		for (auto &filename : apps) {
-			QFile infile(directory + "/" + filename);
-			if (!infile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-				topLog(tr(R"(Could not check application file: unable to read "%1" (%2))").arg(
-				    QDir::toNativeSeparators(filename), infile.errorString()), "error");
-				continue;
-			}
-			QTextStream tstream(&infile);
-			int linecount = 0;
-			while (!tstream.atEnd()) {
-				linecount++;
-				if (linecount > 50) //allow this many lines of comments, but then assume it's not our file
-					break;
-				const QString line( tstream.readLine() );
-				static const QRegularExpression regex_inishell(R"(^\<inishell_config (application|simulation)=\"(.*?)\".*?(icon=\"(.*)\")*>.*)");
-				const QRegularExpressionMatch match_inishell(regex_inishell.match(line)); //^ allow XML comment at the end
-				static const int idx_type = 1;
-				if (match_inishell.captured(0) == line && !line.isEmpty()) {
-					/*
-					 * There is no logical difference between a file containing
-					 * an application and one containing a simulation. The attribute
-					 * is used solemnly for clarity and to keep two separate lists
-					 * for the two.
-					 */
-					if (match_inishell.captured(idx_type).toLower() == "application")
-						applications_->addApplication(infile, match_inishell);
-					else
-						simulations_->addApplication(infile, match_inishell);
-					break;
-				}
-			} //endwhile
-		} //endfor filename
-
-		//display the directory's path as a list separator if it contains valid XMLs:
-		if (applications_->count() > count_before_applications)
-			applications_->addInfoSeparator(directory, count_before_applications);
-		if (simulations_->count() > count_before_simulations)
-			simulations_->addInfoSeparator(directory, count_before_simulations);
-
-	} //endfor directory_list
-
-	applications_found = (applications_->count() > 0); //to display an info when empty
-	simulations_found = (simulations_->count() > 0);
+	QWidgetList element_list;
+	for (auto it = workflow_elements_.constFind(id.toLower());
+	    it != workflow_elements_.constEnd() && it.key() == id.toLower(); ++it) {
+		if (!it.value().isNull() && (parent == nullptr || parent->isAncestorOf(it.value())))
+			element_list.push_front(it.value()); //multi-hash gives the most recent one first
+	}
+	return element_list;
 }
 
 /**
@@ -380,10 +363,9 @@ QString WorkflowPanel::parseCommand(const QString &action, QPushButton *button,
 		const QRegularExpressionMatch match( rit.next() );
 		const QString id(match.captured(0).mid(1)); //ID without %
 
-		const QString internal_id( "_workflow_" + Atomic::getQtKey(id) );
-		QWidgetList input_widget_list( button->parent()->findChildren<QWidget *>(internal_id) );
+		QWidgetList input_widget_list( findWorkflowElements(id, button->parentWidget()) );
 		if (input_widget_list.isEmpty()) //current tab does not have it - look everywhere
-			input_widget_list = this->findChildren<QWidget *>(internal_id);
+			input_widget_list = findWorkflowElements(id);
 		if (input_widget_list.size() > 1)
 			workflowStatus(tr(R"(Multiple elements found for ID "%1")").arg(id), status_label);
 		if (input_widget_list.isEmpty()) {
@@ -472,8 +454,12 @@ bool WorkflowPanel::actionSwitchPath(const QString &command, QLabel *status_labe
 	static const int idx_element = 1;
 	static const int idx_path = 2;
 	if (match_setpath.captured(0) == command && !command.isEmpty()) {
-		auto *path_view = this->findChild<PathView *>("_workflow_" +
-		    Atomic::getQtKey(match_setpath.captured(idx_element)));
+		PathView *path_view = nullptr;
+		for (auto *element : findWorkflowElements(match_setpath.captured(idx_element))) {
+			path_view = qobject_cast<PathView *>(element);
+			if (path_view)
+				break;
+		}
 		/*
 		 * On startup, the loaded INI is not available yet so we need a mechanism
 		 * to change directory, for example to switch to the output folder
@@ -510,10 +496,14 @@ bool WorkflowPanel::actionClickButton(const QString &command, QPushButton *butto
 	const QRegularExpressionMatch match_clickbutton(rex_clickbutton.match(command));
 	static const int idx_button = 1;
 	if (match_clickbutton.captured(0) == command && !command.isEmpty()) {
-		auto *clicked_button = this->findChild<QPushButton *>("_workflow_" + Atomic::getQtKey(
-		    match_clickbutton.captured(idx_button)));
+		QPushButton *clicked_button = nullptr;
+		for (auto *element : findWorkflowElements(match_clickbutton.captured(idx_button))) {
+			clicked_button = qobject_cast<QPushButton *>(element);
+			if (clicked_button)
+				break;
+		}
 		if (clicked_button) {
-			if (clicked_button->objectName() == button->objectName()) {
+			if (clicked_button == button) {
 				workflowStatus(tr("A button can not click itself"), status_label);
 				return true; //TODO: circular clicks still possible --> infinite loop
 			}
@@ -28,9 +28,12 @@
 #include "src/gui/ApplicationsView.h"
 #include "src/gui/TerminalView.h"
 #include "src/gui/IniFolderView.h"
+#include "src/main/AppScanner.h"
 #include "src/main/colors.h"
 
 #include <QLabel>
+#include <QMultiHash>
+#include <QPointer>
 #include <QPushButton>
 #include <QStringList>
 #include <QTimer>
@@ -51,7 +54,7 @@ class WorkflowPanel : public QWidget {
 	private:
 		void buildWorkflowSection(QDomElement &section);
 		QWidget * workflowElementFactory(QDomElement &item, const QString& appname);
-		void readAppsFromDirs(bool &applications_found, bool &simulations_found);
+		QWidgetList findWorkflowElements(const QString &id, const QWidget *parent = nullptr) const;
 		QString parseCommand(const QString &action, QPushButton *button, QLabel *status_label);
 		void commandSubstitutions(QString &command, QLabel *status_label);
 		bool actionOpenUrl(const QString &command) const;
@@ -71,11 +74,16 @@ class WorkflowPanel : public QWidget {
 		ApplicationsView *applications_ = nullptr;
 		ApplicationsView *simulations_ = nullptr;
 		IniFolderView *filesystem_ = nullptr;
+		AppScanner *app_scanner_ = nullptr;
+		IconCache *icon_cache_ = nullptr;
 		bool clicked_button_running_ = false;
+		QMultiHash<QString, QPointer<QWidget>> workflow_elements_; //lower case ID -> elements
 
 	private slots:
 		void buttonClicked(QPushButton *button, const QStringList &action_list, const QString& appname);
 		void toolboxClicked(int index);
+		void onAppDirectoriesFound(const AppScanResult &result);
+		void onAppScanFinished(const AppScanResult &result);
 };
 
 #endif //WORKFLOW_H
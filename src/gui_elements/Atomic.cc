@@ -17,12 +17,17 @@
 */
 
 #include "Atomic.h"
+#include "DocumentModel.h"
+#include "src/main/expressions.h"
 #include "src/main/inishell.h"
 
 #include <QAction>
-#include <QCryptographicHash>
+#include <QApplication>
 #include <QCursor>
+#include <QEvent>
 #include <QFontMetrics>
+#include <QPalette>
+#include <QTimer>
 
 #include <utility>
 
@@ -30,6 +35,14 @@
 	#include <iostream>
 #endif //def DEBUG
 
+QHash<QString, QList<Atomic *>> Atomic::key_registry_;
+KeyTemplateTrie Atomic::template_registry_;
+unsigned int Atomic::registry_revision_ = 0;
+quint64 Atomic::tree_order_counter_ = 0;
+int Atomic::batch_depth_ = 0;
+QHash<QWidget *, QPointer<QWidget>> Atomic::pending_repolish_;
+bool Atomic::repolish_scheduled_ = false;
+
 /**
  * @class Atomic
  * @brief Base class of most panels.
@@ -40,10 +53,19 @@
  * @param[in] parent The parent widget.
  */
 Atomic::Atomic(QString section, QString key, QWidget *parent)
-    : QWidget(parent), section_(std::move(section)), key_(std::move(key))
+    : QWidget(parent), section_(std::move(section)), key_(std::move(key)),
+      tree_order_(++tree_order_counter_)
 {
 	ini_ = getMainWindow()->getIni();
-	createContextMenu();
+}
+
+/**
+ * @brief Destructor for a panel.
+ * @details The panel leaves the key registry so that it can not be found anymore.
+ */
+Atomic::~Atomic()
+{
+	unregisterKey();
 }
 
 /**
@@ -62,18 +84,26 @@ void Atomic::setDefaultPanelStyles(const QString &in_value)
 }
 
 /**
- * @brief Get an alphanumeric key from an aribtrary one.
- * @details Unfortunately, our arg1::arg2 syntax runs into Qt's sub-controls syntax, but the targeting
- * with stylesheets only allows _ and - anyway so we hash the ID. This also ensures that all object
- * names we set manually that contain an underscore or dash do not coincide with an INI setting name.
- *
- * @param[in] ini_key Key as given in the XML
- * @return A key without special chars.
+ * @brief Retrieve the panels that handle an INI key.
+ * @details Panels register their key when they are built, so this is a lookup in the key
+ * registry rather than a search through the widget tree.
+ * @param[in] ini_key The INI key to find (case insensitive).
+ * @param[in] parent If given, only panels within this widget are returned.
+ * @return All matching panels.
  */
-QString Atomic::getQtKey(const QString &ini_key)
-{ //sounds heavy but is fast
-	return QString(QCryptographicHash::hash((ini_key.toLower().toLocal8Bit()),
-	    QCryptographicHash::Md5).toHex());
+QList<Atomic *> Atomic::getPanels(const QString &ini_key, const QWidget *parent)
+{
+	const auto it( key_registry_.constFind(ini_key.toLower()) );
+	if (it == key_registry_.constEnd())
+		return QList<Atomic *>();
+	if (parent == nullptr)
+		return *it;
+	QList<Atomic *> panel_list;
+	for (auto *panel : *it) {
+		if (parent->isAncestorOf(panel))
+			panel_list.push_back(panel);
+	}
+	return panel_list;
 }
 
 /**
@@ -97,15 +127,69 @@ QString Atomic::getIniValue(QString &section, QString &key) const noexcept
 void Atomic::clear(const bool &set_default)
 {
 	/*
-	 * The property needs to actually change to have a signal emitted. So first we set
-	 * the property (since we set it to ini_value_, a check in onPropertySet() will
-	 * make sure that nothing is calculated), and then set it to the default value
-	 * (which will only take effect if it's different).
-	 * TODO: This means unneccessary calls that may not be trivial (depending on the panel),
-	 * so a redesign could be desired.
+	 * setValue() only reaches the panel if the value changes. So first we set the current
+	 * value (a check in onPropertySet() will make sure that nothing is calculated), and
+	 * then the default value (which will only take effect if it's different).
 	 */
-	this->setProperty("ini_value", ini_value_);
-	this->setProperty("ini_value", set_default? this->property("default_value") : QString());
+	setValue(ini_value_);
+	setValue(set_default? this->property("default_value").toString() : QString());
+}
+
+/**
+ * @brief Set a value for the panel to display.
+ * @details This is how values are set from outside the panel (INI files, defaults, ...).
+ * The panel's onPropertySet() is only called if the value differs from the last one.
+ * @param[in] value The value to set.
+ */
+void Atomic::setValue(const QString &value)
+{
+	if (has_requested_value_ && value == requested_value_)
+		return;
+	requested_value_ = value;
+	has_requested_value_ = true;
+	onPropertySet();
+}
+
+/**
+ * @brief Event handler of the panel, forwarding the "ini_value" property to setValue().
+ * @details Setting the "ini_value" property was the original way of setting values and is kept
+ * for compatibility. The property is removed again right away so that the next value always
+ * arrives (setValue() decides if it's new).
+ * @param[in] event The event that has occurred.
+ * @return True if the event was handled.
+ */
+bool Atomic::event(QEvent *event)
+{
+	if (event->type() == QEvent::DynamicPropertyChange &&
+	    static_cast<QDynamicPropertyChangeEvent *>(event)->propertyName() == "ini_value") {
+		const QVariant value( this->property("ini_value") );
+		if (value.isValid()) { //not when it's being removed
+			this->setProperty("ini_value", QVariant());
+			setValue(value.toString());
+		}
+		return true;
+	}
+	if (event->type() == QEvent::ParentChange) { //moved to the end of the new parent's children
+		tree_order_ = ++tree_order_counter_;
+		DocumentModel::getShared().invalidateStructure();
+	}
+	return QWidget::event(event);
+}
+
+/**
+ * @brief Show or hide the panel.
+ * @details Panels with child panels show and hide them according to the user's choices
+ * (e. g. Dropdown items), and only visible panels contribute to the INI file. The document model
+ * is told about it, except for the section tabs being switched.
+ * @param[in] visible True to show the panel, false to hide it.
+ */
+void Atomic::setVisible(bool visible)
+{
+	const bool was_hidden = isHidden();
+	QWidget::setVisible(visible);
+	DocumentModel &model( DocumentModel::getShared() );
+	if (isHidden() != was_hidden && !model.isSectionPage(this))
+		model.invalidateVisibility(this);
 }
 
 /**
@@ -116,22 +200,86 @@ void Atomic::clear(const bool &set_default)
  */
 void Atomic::setPrimaryWidget(QWidget *primary_widget, const bool &set_object_name, const bool &no_styles)
 {
-	primary_widget_ = primary_widget;
-	primary_widget->setObjectName("_primary_" + getQtKey(getId()));
+	primary_widget_ = primary_widget; //found through the key registry, no object name needed
 	if (set_object_name) //template panels may want to do this themselves (handling substitutions)
-		this->setObjectName(getQtKey(getId()));
-	QObject *const property_watcher( new PropertyWatcher(primary_widget) );
-	this->connect(property_watcher, SIGNAL(changedValue()), SLOT(onPropertySet())); //old style for easy delegation
-	this->installEventFilter(property_watcher);
+		registerKey(getId());
 	if (!no_styles) //panels that style different widgets than the primary one (e. g. Choice)
-		setDefaultPanelStyles(this->property("ini_value").toString());
+		setDefaultPanelStyles(requested_value_);
 	this->setContextMenuPolicy(Qt::CustomContextMenu);
-	connect(this, &QWidget::customContextMenuRequested, this, &Atomic::onConextMenuRequest);
+	connect(this, &QWidget::customContextMenuRequested, this, &Atomic::onConextMenuRequest,
+	    Qt::UniqueConnection);
+}
+
+/**
+ * @brief Make the panel available in the key registry.
+ * @details INI keys are case insensitive, so the registry is keyed by the lower case version.
+ * A panel is registered for one key only, registering again replaces the previous key.
+ * Dynamic panels additionally enter their template key into the template tree.
+ * @param[in] ini_key The key to find the panel by.
+ * @param[in] is_template Set for panels that create child panels from their key's wildcards.
+ */
+void Atomic::registerKey(const QString &ini_key, const bool &is_template)
+{
+	const QString normalized_key( ini_key.toLower() );
+	if (normalized_key == registered_key_) //e. g. Number switching its primary widget
+		return;
+	unregisterKey();
+	registered_key_ = normalized_key;
+	key_registry_[registered_key_].push_back(this);
+	registered_template_ = is_template && KeyTemplateTrie::hasWildcard(registered_key_);
+	if (registered_template_)
+		template_registry_.insert(registered_key_, this);
+	++registry_revision_;
+	DocumentModel::getShared().addPanel(this, ini_value_);
+	expr::ExpressionGraph::getShared().keyChanged(registered_key_); //expressions may refer to it
+}
+
+/**
+ * @brief Remove the panel from the key registry.
+ */
+void Atomic::unregisterKey()
+{
+	if (registered_key_.isNull())
+		return;
+	const auto it( key_registry_.find(registered_key_) );
+	if (it != key_registry_.end()) {
+		it->removeOne(this);
+		if (it->isEmpty())
+			key_registry_.erase(it);
+	}
+	if (registered_template_)
+		template_registry_.remove(registered_key_, this);
+	DocumentModel::getShared().removePanel(this);
+	expr::ExpressionGraph::getShared().keyChanged(registered_key_);
+	registered_key_ = QString();
+	registered_template_ = false;
+}
+
+/**
+ * @brief Temporarily take the panel out of the key registry, or put it back in.
+ * @details Panels that are kept for later reuse (cf. ItemTemplate) must not be found by INI keys
+ * while they are not part of the GUI.
+ * @param[in] registered False to suspend the registration, true to restore it.
+ */
+void Atomic::setRegistered(const bool &registered)
+{
+	if (!registered) {
+		if (registered_key_.isNull())
+			return;
+		suspended_key_ = registered_key_;
+		suspended_template_ = registered_template_;
+		unregisterKey();
+	} else if (!suspended_key_.isNull()) {
+		registerKey(suspended_key_, suspended_template_);
+		suspended_key_ = QString();
+	}
 }
 
 /**
  * @brief Set a property indicating that the value this panel controls is defaulted or mandatory,
  * or to be highlighted in a different way.
+ * @details The styles a widget currently shows are kept as a bitmask in its "style_state" property,
+ * so that setting a style it already has does not trigger a restyle.
  * @param[in] set Set style on/off.
  * @param[in] widget If given, set the style for this widget instead of the primary one
  * (used in Choice panel for example).
@@ -142,25 +290,76 @@ void Atomic::setPanelStyle(const PanelStyle &style, const bool &set, QWidget *wi
 	if (widget_to_set == nullptr) //e. g. horizontal panel
 		return;
 
-	QString style_string;
-	switch (style) {
-	case MANDATORY:
-		style_string = "mandatory";
-		break;
-	case DEFAULT:
-		style_string = "shows_default";
-		break;
-	case FAULTY:
-		style_string = "faulty";
-		break;
-	case VALID:
-		style_string = "valid";
-	}
-	widget_to_set->setProperty(style_string.toLocal8Bit(), set? "true" : "false");
-	this->style()->unpolish(widget_to_set); //if a property is set dynamically, we might have to refresh
-	this->style()->polish(widget_to_set);
+	const int old_state = widget_to_set->property("style_state").toInt();
+	const int new_state = set? (old_state | (1 << style)) : (old_state & ~(1 << style));
+	if (new_state == old_state)
+		return; //nothing changes visually (a missing style property counts as "false")
+
+	static const char *style_properties[] = {"mandatory", "shows_default", "valid", "faulty"}; //by PanelStyle
+	widget_to_set->setProperty("style_state", new_state);
+	widget_to_set->setProperty(style_properties[style], set? "true" : "false");
+	repolish(widget_to_set); //if a property is set dynamically, we might have to refresh
 } //https://wiki.qt.io/Technical_FAQ#How_can_my_stylesheet_account_for_custom_properties.3F
 
+/**
+ * @brief Re-apply the stylesheet to a widget after a style property has changed.
+ * @details The widget is only remembered and restyled once, with whatever style properties it
+ * has then, when control returns to the event loop (or when the running batch ends). This way
+ * several style changes of the same widget cost a single unpolish/polish.
+ * @param[in] widget The widget to restyle.
+ */
+void Atomic::repolish(QWidget *widget)
+{
+	if (widget == nullptr)
+		return;
+	QPointer<QWidget> &pending( pending_repolish_[widget] );
+	if (pending.isNull()) //new, or a deleted widget's address was reused
+		pending = widget;
+	if (batch_depth_ > 0 || repolish_scheduled_)
+		return;
+	repolish_scheduled_ = true;
+	QTimer::singleShot(0, qApp, []{ flushRepolish(); });
+}
+
+/**
+ * @brief Restyle all widgets whose style properties have changed.
+ * @details Nothing is done while a batch is running, the batch will flush when it ends.
+ * @return The number of widgets that were restyled.
+ */
+int Atomic::flushRepolish()
+{
+	repolish_scheduled_ = false;
+	if (batch_depth_ > 0)
+		return 0;
+
+	int restyled = 0;
+	const QHash<QWidget *, QPointer<QWidget>> pending( std::move(pending_repolish_) );
+	pending_repolish_.clear();
+	for (auto &widget : pending) {
+		if (widget.isNull()) //deleted in the meantime
+			continue;
+		widget->style()->unpolish(widget);
+		widget->style()->polish(widget);
+		++restyled;
+	}
+	return restyled;
+}
+
+/**
+ * @brief End setting values in a batch.
+ * @details When the outermost batch ends, all widgets whose style properties have changed
+ * are restyled once.
+ * @return The number of widgets that were restyled, or -1 if an outer batch is still open.
+ */
+int Atomic::endBatchUpdate()
+{
+	if (batch_depth_ > 0)
+		--batch_depth_;
+	if (batch_depth_ > 0)
+		return -1;
+	return flushRepolish();
+}
+
 /**
  * @brief Switch between "faulty" and "valid" panel styles.
  * @param[in] on True to set "faulty", false to set "valid".
@@ -297,29 +496,48 @@ int Atomic::getElementTextWidth(const QStringList &text_list, const int &element
 }
 
 /**
- * @brief Set font stylesheet for an object.
+ * @brief Set the caption font of an object.
+ * @details The font and palette are set directly so that no stylesheet needs to be parsed.
+ * Properties of the application's stylesheet (e. g. for default values) still take precedence.
  * @param[in] widget The widget to style the font of.
  * @param[in] options XML user options to parse.
  */
 void Atomic::setFontOptions(QWidget *widget, const QDomNode &options)
 {
 	const QDomElement op( options.toElement() );
-	QString stylesheet( widget->metaObject()->className() );
-	stylesheet += " {";
+	QFont font( widget->font() );
 	if (op.attribute("caption_bold").toLower() == "true")
-		stylesheet += "font-weight: bold; ";
+		font.setBold(true);
 	if (op.attribute("caption_italic").toLower() == "true")
-		stylesheet += "font-style: italic; ";
+		font.setItalic(true);
 	if (!op.attribute("caption_font").isNull())
-		stylesheet += "font-family: \"" + op.attribute("caption_font") + "\"; ";
+		font.setFamily(op.attribute("caption_font"));
 	if (op.attribute("caption_underline").toLower() == "true")
-		stylesheet += "text-decoration: underline; ";
-	if (!op.attribute("caption_size").isNull())
-		stylesheet += "font-size: " + op.attribute("caption_size") + "pt; ";
+		font.setUnderline(true);
+	if (!op.attribute("caption_size").isNull()) {
+		bool size_ok;
+		const double caption_size = op.attribute("caption_size").toDouble(&size_ok);
+		if (size_ok && caption_size > 0.) //e. g. "10.5" - keep the current size for invalid input
+			font.setPointSizeF(caption_size);
+	}
+	if (font != widget->font())
+		widget->setFont(font);
 	if (!op.attribute("caption_color").isNull())
-		stylesheet += "color: " + colors::getQColor(op.attribute("caption_color")).name() + "; ";
-	stylesheet += "}";
-	widget->setStyleSheet(stylesheet);
+		setTextColor(widget, colors::getQColor(op.attribute("caption_color")));
+}
+
+/**
+ * @brief Set the text color of a widget via its palette.
+ * @param[in] widget The widget to color the text of.
+ * @param[in] color The text color.
+ */
+void Atomic::setTextColor(QWidget *widget, const QColor &color)
+{
+	QPalette palette( widget->palette() );
+	palette.setColor(QPalette::WindowText, color);
+	palette.setColor(QPalette::ButtonText, color);
+	palette.setColor(QPalette::Text, color);
+	widget->setPalette(palette);
 }
 
 /**
@@ -338,8 +556,12 @@ QFont Atomic::setFontOptions(const QFont &item_font, const QDomElement &options)
 	retFont.setUnderline(options.attribute("underline").toLower() == "true");
 	if (!options.attribute("font").isEmpty())
 		retFont.setFamily(options.attribute("font"));
-	if (!options.attribute("font_size").isEmpty())
-		retFont.setPointSize(options.attribute("font_size").toInt());
+	if (!options.attribute("font_size").isEmpty()) {
+		bool size_ok;
+		const double font_size = options.attribute("font_size").toDouble(&size_ok);
+		if (size_ok && font_size > 0.)
+			retFont.setPointSizeF(font_size);
+	}
 	return retFont;
 }
 
@@ -382,24 +604,19 @@ void Atomic::setIniValue(const double &value)
  */
 void Atomic::setIniValue(const QString &value)
 {
+	const QString previous_value( ini_value_ );
 	ini_value_ = value;
 
 	//HACK this is needed as a workaround for KDE bug https://bugs.kde.org/show_bug.cgi?id=337491
 #if defined Q_OS_LINUX || defined Q_OS_FREEBSD //we assume the kde is only used on Linux and FreeBSD
 	ini_value_.replace("&", "");
 #endif
-}
-
-/**
- * @brief Prepare the panel's custom context menu.
- */
-void Atomic::createContextMenu()
-{
-	QAction *info_entry( panel_context_menu_.addAction(key_) );
-	info_entry->setEnabled(false);
-	panel_context_menu_.addSeparator();
-	panel_context_menu_.addAction(tr("Reset to default"));
-	panel_context_menu_.addAction(tr("Delete key"));
+	if (ini_value_ == previous_value)
+		return;
+	if (!registered_key_.isNull()) {
+		DocumentModel::getShared().setValue(this, ini_value_);
+		expr::ExpressionGraph::getShared().keyChanged(registered_key_);
+	}
 }
 
 /**
@@ -420,11 +637,20 @@ void Atomic::onConextMenuRequest(const QPoint &/*pos*/)
 		return;
 	if (qobject_cast<Group *>(this)) //e. g. Selector/Replicator containers
 		return;
-	QAction *selected( panel_context_menu_.exec(QCursor::pos()) );
-	if (selected) {
-		if (selected->text() == tr("Reset to default"))
-			clear();
-		else if (selected->text() == tr("Delete key"))
-			clear(false);
-	}
+	/* all panels share one menu which is filled for the panel it pops up for */
+	static QPointer<QMenu> panel_context_menu;
+	if (panel_context_menu.isNull())
+		panel_context_menu = new QMenu(getMainWindow());
+	panel_context_menu->clear();
+	QAction *info_entry( panel_context_menu->addAction(key_) );
+	info_entry->setEnabled(false);
+	panel_context_menu->addSeparator();
+	const QAction *reset_entry( panel_context_menu->addAction(tr("Reset to default")) );
+	const QAction *delete_entry( panel_context_menu->addAction(tr("Delete key")) );
+
+	const QAction *selected( panel_context_menu->exec(QCursor::pos()) );
+	if (selected == reset_entry)
+		clear();
+	else if (selected == delete_entry)
+		clear(false);
 }
@@ -25,13 +25,17 @@
 #define ATOMIC_H
 
 #include "src/gui_elements/Helptext.h"
+#include "src/gui_elements/KeyTemplateTrie.h"
 #include "src/main/common.h"
 #include "src/main/constants.h"
 #include "src/main/INIParser.h"
 
 #include <QFont>
+#include <QHash>
 #include <QHBoxLayout>
+#include <QList>
 #include <QMenu>
+#include <QPointer>
 #include <QSpacerItem>
 #include <QString>
 #include <QStringList>
@@ -49,15 +53,36 @@ class Atomic : public QWidget {
 			FAULTY
 		};
 		Atomic(QString section, QString key, QWidget *parent = nullptr);
+		~Atomic() override;
+		Atomic(const Atomic&) = delete;
+		Atomic& operator =(Atomic const&) = delete;
+		Atomic(Atomic&&) = delete;
+		Atomic& operator=(Atomic&&) = delete;
 		virtual void setDefaultPanelStyles(const QString &in_value);
-		static QString getQtKey(const QString &ini_key);
+		static QList<Atomic *> getPanels(const QString &ini_key, const QWidget *parent = nullptr);
+		static std::vector<KeyTemplateMatch> getTemplates(const QString &ini_key) {
+			return template_registry_.match(ini_key); }
+		static unsigned int getRegistryRevision() noexcept { return registry_revision_; }
+		quint64 getTreeOrder() const noexcept { return tree_order_; }
+		QString getRegisteredKey() const noexcept { return registered_key_; }
+		void setVisible(bool visible) override;
+		static void beginBatchUpdate() noexcept { ++batch_depth_; }
+		static int endBatchUpdate();
+		static void repolish(QWidget *widget);
 		QString getIniValue(QString &section, QString &key) const noexcept;
+		void setValue(const QString &value);
+		void setValue(const int &value) { setValue(QString::number(value)); }
+		void setValue(const double &value) { setValue(QString::number(value)); }
 		virtual void clear(const bool &set_default = true);
+		void setRegistered(const bool &registered);
 
 	protected:
+		bool event(QEvent *event) override;
+		const QString & getRequestedValue() const noexcept { return requested_value_; }
 		QWidget * getPrimaryWidget() { return primary_widget_; }
 		void setPrimaryWidget(QWidget *primary_widget, const bool &set_object_name = true,
 		    const bool &no_styles = false);
+		void registerKey(const QString &ini_key, const bool &is_template = false);
 		QString getId() const noexcept { return section_ + Cst::sep + key_; }
 		void setPanelStyle(const PanelStyle &style, const bool &set = true, QWidget *widget = nullptr);
 		void setValidPanelStyle(const bool &on);
@@ -71,6 +96,7 @@ class Atomic : public QWidget {
 		int getElementTextWidth (const QStringList &text_list, const int &element_min_width,
 		    const int &element_max_width);
 		void setFontOptions(QWidget *widget, const QDomNode &options);
+		static void setTextColor(QWidget *widget, const QColor &color);
 		QFont setFontOptions(const QFont &item_font, const QDomElement &in_options);
 
 		QString section_; //INI section
@@ -85,10 +111,24 @@ class Atomic : public QWidget {
 		void setIniValue(const QString &value);
 
 	private:
-		void createContextMenu();
+		static int flushRepolish();
+		void unregisterKey();
 
-		QMenu panel_context_menu_;
 		INIParser *ini_ = nullptr; //pointer to the main INIParser
+		QString requested_value_; //value last set from outside via setValue()
+		bool has_requested_value_ = false;
+		QString registered_key_; //normalized key the panel can be found by
+		bool registered_template_ = false; //panel creates children from its template key
+		QString suspended_key_; //registered key while the panel is not in use (pooled)
+		bool suspended_template_ = false;
+		quint64 tree_order_ = 0; //creation stamp to sort panels in the order they are displayed
+		static quint64 tree_order_counter_;
+		static QHash<QString, QList<Atomic *>> key_registry_; //normalized key -> panels
+		static KeyTemplateTrie template_registry_; //template keys of dynamic panels
+		static unsigned int registry_revision_; //counts registrations to detect new panels
+		static int batch_depth_; //> 0 while many values are set at once
+		static QHash<QWidget *, QPointer<QWidget>> pending_repolish_; //widgets waiting to be restyled
+		static bool repolish_scheduled_; //a restyle is queued for the next event loop turn
 
 	private slots:
 		void onTimerBufferedUpdatesEnabled();
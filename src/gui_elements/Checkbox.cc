@@ -103,12 +103,12 @@ void Checkbox::setOptions(const QDomNode &options)
 
 /**
  * @brief Event listener for changed INI values.
- * @details The "ini_value" property is set when parsing default values and potentially again
+ * @details The panel's value is set via setValue() when parsing default values and potentially again
  * when setting INI keys while parsing a file.
  */
 void Checkbox::onPropertySet()
 {
-	const QString value( this->property("ini_value").toString() );
+	const QString value( getRequestedValue() );
 	const QString value_lc( value.toLower() );
 	if (ini_value_ == value)
 		return;
@@ -118,7 +118,7 @@ void Checkbox::onPropertySet()
 		checkbox_->setCheckState(Qt::Unchecked);
 	} else if (value.isEmpty()) { //the panel is being cleared
 		checkbox_->setCheckState(Qt::Unchecked);
-		ini_value_ = QString();
+		setIniValue(QString());
 		return;
 	} else {
 		topLog(tr(R"(Ignored non-boolean value "%1" for checkbox "%2::%3")").arg(
@@ -105,6 +105,9 @@ void Checklist::setOptions(const QDomNode &options)
 		recursiveBuild(op, item_group, section_);
 		child_container_->addWidget(item_group);
 		item_group->setVisible(false); //becomes visible when checked
+		item_groups_.insert(item, item_group);
+		if (!item_index_.contains(value.toLower())) //first option wins for duplicates
+			item_index_.insert(value.toLower(), item);
 
 		if (op.attribute("default").toLower() == "true") {
 			const QString def_val( this->property("default_value").toString() );
@@ -127,6 +130,15 @@ void Checklist::setOptions(const QDomNode &options)
 	list_->setMinimumWidth(getElementTextWidth(item_strings, Cst::tiny, Cst::width_checklist_max) +
 	    Cst::checklist_safety_padding_horizontal);
 	list_->setMaximumWidth(Cst::width_checklist_max);
+
+	if (list_->count() >= Cst::checklist_filter_min_items) { //type-ahead filtering for long lists
+		filter_edit_ = new QLineEdit;
+		filter_edit_->setPlaceholderText(tr("<filter>"));
+		filter_edit_->setClearButtonEnabled(true);
+		filter_edit_->setMaximumWidth(Cst::width_checklist_max);
+		connect(filter_edit_, &QLineEdit::textChanged, this, &Checklist::filterItems);
+		checklist_layout_->insertWidget(0, filter_edit_);
+	}
 }
 
 /**
@@ -149,22 +161,17 @@ QString Checklist::getOrderedIniList() const
  */
 void Checklist::setChildVisibility(QListWidgetItem *item)
 {
-	const QLayout *group_layout( child_container_->getLayout() );
-	auto *item_group( static_cast<Group *>(group_layout->itemAt(list_->currentRow())->widget()) );
+	Group *item_group( item_groups_.value(item) );
 
 	bool one_visible = false;
-	bool all_unchecked = true;
-	for (int ii = 0; ii < list_->count(); ++ii) {
-		if (list_->item(ii)->checkState() == Qt::Checked) {
-			all_unchecked = false;
-			if (!static_cast<Group *>(group_layout->itemAt(ii)->widget())->isEmpty()) {
-				one_visible = true; //hide container if empty (a few blank pixels)
-				break;
-			}
+	for (auto &checked_item : ordered_item_list_) { //only the checked items can show children
+		if (!item_groups_.value(checked_item)->isEmpty()) {
+			one_visible = true; //hide container if empty (a few blank pixels)
+			break;
 		}
 	}
 	child_container_->setVisible(one_visible);
-	if (all_unchecked) //switch back to main help:
+	if (ordered_item_list_.empty()) //switch back to main help:
 		main_help_->updateText(main_help_->property("main_help").toString());
 
 	item_group->setVisible(item->checkState() == Qt::Checked && !item_group->isEmpty());
@@ -203,38 +210,48 @@ void Checklist::listClick(QListWidgetItem *item)
 
 /**
  * @brief Event listener for changed INI values.
- * @details The "ini_value" property is set when parsing default values and potentially again
+ * @details The panel's value is set via setValue() when parsing default values and potentially again
  * when setting INI keys while parsing a file.
  */
 void Checklist::onPropertySet()
 {
-	const QString values( this->property("ini_value").toString() );
+	const QString values( getRequestedValue() );
 	if (ini_value_ == values)
 		return;
 	const QStringList value_list( values.split(QRegExp("\\s+"), QString::SkipEmptyParts) );
 
 	/* clear the list, overwriting current settings */
-	for (int ii = 0; ii < list_->count(); ++ii) {
-		if (list_->item(ii)->checkState() == Qt::Checked) {
-			list_->setCurrentRow(ii);
-			emit listClick(list_->item(ii)); //unload child panels
-		}
+	const std::vector<QListWidgetItem *> checked_items( ordered_item_list_ ); //clicking modifies the list
+	for (auto &item : checked_items) {
+		list_->setCurrentItem(item);
+		emit listClick(item); //unload child panels
 	}
 
 	/* check all items found in the given value */
 	for (auto &val : value_list) {
 		//Note: since we find and click the checkbox for each value they are correctly inserted into the ordering
-		bool found_option_to_set = false;
-		for (int jj = 0; jj < list_->count(); ++jj) {
-			if (QString::compare(list_->item(jj)->text(), val, Qt::CaseInsensitive) == 0) {
-				list_->setCurrentRow(jj); //else we will get NULL when we fetch the item
-				emit listClick(list_->item(jj)); //to set the default value
-				found_option_to_set = true;
-				break;
-			}
-		} //endfor jj
-		if (!found_option_to_set)
+		QListWidgetItem *item( item_index_.value(val.toLower(), nullptr) );
+		if (item == nullptr) {
 			topLog(tr(R"(Checklist item "%1" could not be set from INI file for key "%2::%3": no such option specified in XML file)").arg(
 			    val, section_, key_), "warning");
-	} //endfor ii
+			continue;
+		}
+		list_->setCurrentItem(item); //else we will get NULL when we fetch the item
+		emit listClick(item); //to set the default value
+	} //endfor val
+}
+
+/**
+ * @brief Show only the list items that contain a text.
+ * @details The items stay in the list, non-matching rows are only hidden (checked items
+ * are always shown).
+ * @param[in] filter Text to search for (case insensitive). Show all items if empty.
+ */
+void Checklist::filterItems(const QString &filter)
+{
+	for (int ii = 0; ii < list_->count(); ++ii) {
+		QListWidgetItem *item( list_->item(ii) );
+		item->setHidden(!filter.isEmpty() && item->checkState() != Qt::Checked &&
+		    !item->text().contains(filter, Qt::CaseInsensitive));
+	}
 }
@@ -29,7 +29,9 @@
 #include "Group.h"
 #include "Helptext.h"
 
+#include <QHash>
 #include <QHBoxLayout>
+#include <QLineEdit>
 #include <QListWidget>
 #include <QString>
 #include <QWidget>
@@ -50,7 +52,10 @@ class Checklist : public Atomic {
 		void setChildVisibility(QListWidgetItem *item);
 
 		std::vector<QListWidgetItem *> ordered_item_list_; //order items were checked in
+		QHash<QString, QListWidgetItem *> item_index_; //lower case option value -> list item
+		QHash<QListWidgetItem *, Group *> item_groups_; //list item -> its child panels
 		QListWidget *list_ = nullptr;
+		QLineEdit *filter_edit_ = nullptr; //only for long lists
 		Group *child_container_ = nullptr;
 		QVBoxLayout *checklist_layout_ = nullptr;
 		Helptext *main_help_ = nullptr;
@@ -58,6 +63,7 @@ class Checklist : public Atomic {
 
 	private slots:
 		void listClick(QListWidgetItem *);
+		void filterItems(const QString &filter);
 		void onPropertySet() override;
 };
 
@@ -74,9 +74,8 @@ Choice::Choice(const QString &section, const QString &key, const QDomNode &optio
  */
 void Choice::setDefaultPanelStyles(const QString &in_value)
 {
-	const QList<QCheckBox *> cb_list( checkbox_container_->findChildren<QCheckBox *>() );
 	const bool is_default = (QString::compare(in_value, this->property("default_value").toString(), Qt::CaseInsensitive) == 0);
-	for (auto &cb : cb_list) {
+	for (auto &cb : checkboxes_) {
 		setPanelStyle(FAULTY, false, cb); //first we disable temporary styles
 		setPanelStyle(VALID, false, cb);
 		setPanelStyle(DEFAULT, is_default && !in_value.isNull() && !this->property("default_value").isNull(), cb);
@@ -103,10 +102,13 @@ void Choice::setOptions(const QDomNode &options)
 		//connect to lambda function to emit current index (modern style signal mapping):
 		connect(checkbox, &QCheckBox::stateChanged, this, [=] { changedState(counter); });
 		checkbox_container_->addWidget(checkbox, counter, 0);
+		checkboxes_.push_back(checkbox);
+		if (!option_index_.contains(op.attribute("value").toLower())) //first option wins for duplicates
+			option_index_.insert(op.attribute("value").toLower(), counter);
 
 		/* set item properties */
 		if (!op.attribute("color").isEmpty())
-			checkbox->setStyleSheet("QCheckBox {color: " + colors::getQColor(op.attribute("color")).name() + "}");
+			setTextColor(checkbox, colors::getQColor(op.attribute("color")));
 		checkbox->setFont(setFontOptions(checkbox->font(), op));
 
 		/* help text */
@@ -126,6 +128,7 @@ void Choice::setOptions(const QDomNode &options)
 		recursiveBuild(op, item_group, section_);
 		item_group->setVisible(false);
 		child_container_->addWidget(item_group);
+		item_groups_.push_back(item_group);
 		counter++;
 
 		if (op.attribute("default").toLower() == "true") { //collect default values declared via attributes
@@ -143,11 +146,8 @@ void Choice::setOptions(const QDomNode &options)
 QString Choice::getOrderedIniList() const
 {
 	QString list_values;
-	for (auto &it : ordered_item_list_) {
-		auto *box_nr = qobject_cast<QCheckBox *>(
-		   checkbox_container_->getGridLayout()->itemAtPosition(it, 0)->widget());
-		list_values += box_nr->text() + " "; //collect values as "value1 value2 value3..."
-	}
+	for (auto &it : ordered_item_list_)
+		list_values += checkboxes_.at(static_cast<size_t>(it))->text() + " "; //collect values as "value1 value2 value3..."
 	list_values.chop(1); //trailing space (if available)
 	return list_values;
 }
@@ -159,21 +159,16 @@ QString Choice::getOrderedIniList() const
  */
 void Choice::setChildVisibility(const int &index, const Qt::CheckState &checked)
 {
-	const QLayout *group_layout( child_container_->getLayout() ); //get item number 'index' from the child group's layout
-	auto *item_group( qobject_cast<Group *>(group_layout->itemAt(index)->widget()) );
+	Group *item_group( item_groups_.at(static_cast<size_t>(index)) );
 
-	//Run through all checkboxes and find out if at least one shows children.
+	//Run through all checked boxes and find out if at least one shows children.
 	//This is done to hide the main container if not one child panel is visible,
 	//saving a few pixels that would seem out of place.
 	bool one_visible = false;
-	for (int ii = 0; ii < checkbox_container_->getGridLayout()->rowCount(); ++ii) {
-		auto *checkbox = qobject_cast<QCheckBox *>(checkbox_container_->getGridLayout()->
-		    itemAtPosition(ii, 0)->widget());
-		if (checkbox->checkState() == Qt::Checked) {
-			if (!static_cast<Group *>(group_layout->itemAt(ii)->widget())->isEmpty()) {
-				one_visible = true;
-				break;
-			}
+	for (auto &checked_index : ordered_item_list_) {
+		if (!item_groups_.at(static_cast<size_t>(checked_index))->isEmpty()) {
+			one_visible = true;
+			break;
 		}
 	}
 
@@ -189,8 +184,7 @@ void Choice::setChildVisibility(const int &index, const Qt::CheckState &checked)
  */
 void Choice::changedState(int index)
 {
-	auto *clicked_box = qobject_cast<QCheckBox *>(
-	    checkbox_container_->getGridLayout()->itemAtPosition(index, 0)->widget());
+	QCheckBox *clicked_box( checkboxes_.at(static_cast<size_t>(index)) );
 
 	if (clicked_box->checkState() == Qt::Unchecked) {
 		auto erase_it( std::find(ordered_item_list_.begin(), ordered_item_list_.end(), index) );
@@ -212,13 +206,13 @@ void Choice::changedState(int index)
 
 /**
  * @brief Event listener for changed INI values.
- * @details The "ini_value" property is set when parsing default values and potentially again
+ * @details The panel's value is set via setValue() when parsing default values and potentially again
  * when setting INI keys while parsing a file.
  */
 void Choice::onPropertySet()
 {
 	//in this case the INI value is a list of options to set, i. e. "key = value1 value2 value3..."
-	const QString values( this->property("ini_value").toString() );
+	const QString values( getRequestedValue() );
 	if (ini_value_ == values)
 		return;
 	const QStringList value_list( values.split(QRegExp("\\s+"), QString::SkipEmptyParts) );
@@ -230,26 +224,18 @@ void Choice::onPropertySet()
 	}
 
 	//clear the list first (so that INI settings can overwrite XML settings):
-	for (int ii = 0; ii < checkbox_container_->getGridLayout()->rowCount(); ++ii) {
-		auto *checkbox = qobject_cast<QCheckBox *>(checkbox_container_->getGridLayout()->
-		    itemAtPosition(ii, 0)->widget());
-		checkbox->setCheckState(Qt::Unchecked);
-	}
+	const std::vector<int> checked_indices( ordered_item_list_ ); //unchecking modifies the list
+	for (auto &idx : checked_indices)
+		checkboxes_.at(static_cast<size_t>(idx))->setCheckState(Qt::Unchecked);
 
 	for (auto &val : value_list) { //run through INI value list and find corresponding checkboxes
 		//Note: since we find and click the checkbox for each value they are correctly inserted into the ordering
-		bool found_option_to_set = false;
-		for (int jj = 0; jj < checkbox_container_->getGridLayout()->rowCount(); ++jj) {
-			auto *checkbox = qobject_cast<QCheckBox *>(checkbox_container_->getGridLayout()->
-			    itemAtPosition(jj, 0)->widget());
-			if (QString::compare(checkbox->text(), val, Qt::CaseInsensitive) == 0) {
-				checkbox->setCheckState(Qt::Checked);
-				found_option_to_set = true; //an XML value exists for this INI value
-				break;
-			}
-		}
-		if (!found_option_to_set)
+		const int idx = option_index_.value(val.toLower(), -1);
+		if (idx == -1) {
 			topLog(tr(R"(Choice item \"%1\" could not be set from INI file for key "%2::%3": no such option specified in XML file)").arg(
 			    val, section_, key_), "warning");
-	} //endfor ii
+			continue;
+		}
+		checkboxes_.at(static_cast<size_t>(idx))->setCheckState(Qt::Checked);
+	} //endfor val
 }
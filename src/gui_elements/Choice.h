@@ -29,6 +29,7 @@
 #include "Group.h"
 
 #include <QCheckBox>
+#include <QHash>
 #include <QString>
 #include <QtXml>
 
@@ -48,6 +49,9 @@ class Choice : public Atomic {
 		void setChildVisibility(const int &index, const Qt::CheckState &checked);
 
 		std::vector<int> ordered_item_list_; //order items were checked in
+		std::vector<QCheckBox *> checkboxes_; //by index
+		std::vector<Group *> item_groups_; //child panels of each checkbox
+		QHash<QString, int> option_index_; //lower case option value -> index
 		Group * checkbox_container_ = nullptr;
 		Group * child_container_ = nullptr;
 
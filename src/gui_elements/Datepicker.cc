@@ -18,7 +18,6 @@
 
 #include "Datepicker.h"
 #include "Label.h"
-#include "src/main/colors.h"
 
 #ifdef DEBUG
 	#include <iostream>
@@ -45,9 +44,8 @@ bool DateKeyPressFilter::eventFilter(QObject *object, QEvent *event)
 				 */
 				object->setProperty("empty", "false");
 				auto *panel = qobject_cast<QDateTimeEdit*>(object);
-				panel->parent()->setProperty("ini_value", QDateTime::currentDateTime().toString());
-				panel->style()->unpolish(panel);
-				panel->style()->polish(panel);
+				qobject_cast<Atomic *>(panel->parent())->setValue(QDateTime::currentDateTime().toString());
+				Atomic::repolish(panel);
 			} //endif property
 		} //endif key_event
 	}
@@ -108,23 +106,17 @@ void Datepicker::setOptions(const QDomNode &options)
 	if (!user_date_format.isEmpty())
 		date_format_ = user_date_format;
 	datepicker_->setDisplayFormat(date_format_);
-
-	/* allow to set "empty" via the property system */
-	QString bg_color( colors::getQColor("app_bg").name() );
-	//find font color to use for hidden datepicker dependent on background color:
-	if (options.toElement().attribute("optional").toLower() == "false")
-		bg_color = colors::getQColor("mandatory").name();
-	datepicker_->setStyleSheet("* [empty=\"true\"] {color: " + bg_color + "}");
+	//the "empty" property hides the text (cf. application stylesheet)
 }
 
 /**
  * @brief Event listener for changed INI values.
- * @details The "ini_value" property is set when parsing default values and potentially again
+ * @details The panel's value is set via setValue() when parsing default values and potentially again
  * when setting INI keys while parsing a file.
  */
 void Datepicker::onPropertySet()
 {
-	const QString text_to_set( this->property("ini_value").toString() );
+	const QString text_to_set( getRequestedValue() );
 	if (ini_value_ == text_to_set)
 		return;
 
@@ -169,7 +161,8 @@ void Datepicker::checkValue(const QDateTime &datetime)
  */
 void Datepicker::setEmpty(const bool &is_empty)
 {
+	if (datepicker_->property("empty").toBool() == is_empty)
+		return;
 	datepicker_->setProperty("empty", is_empty);
-	this->style()->unpolish(datepicker_);
-	this->style()->polish(datepicker_);
+	repolish(datepicker_);
 }
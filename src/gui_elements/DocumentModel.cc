@@ -0,0 +1,462 @@
+/*****************************************************************************/
+/*  Copyright 2019 WSL Institute for Snow and Avalanche Research  SLF-DAVOS  */
+/*****************************************************************************/
+/* This file is part of INIshell.
+   INIshell is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   INIshell is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with INIshell.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "DocumentModel.h"
+#include "Atomic.h"
+#include "KeyTemplateTrie.h"
+#include "src/main/common.h"
+#include "src/main/inishell.h"
+
+#include <QRegExp>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+/**
+ * @class DocumentModel
+ * @brief Get the document model that all panels report to.
+ * @return The shared document model (created on first use).
+ */
+DocumentModel & DocumentModel::getShared()
+{
+	static DocumentModel model;
+	return model;
+}
+
+/**
+ * @brief Add a panel to the document.
+ * @details This happens when the panel enters the key registry.
+ * @param[in] panel The panel that controls an INI key.
+ * @param[in] value The panel's current INI value.
+ */
+void DocumentModel::addPanel(Atomic *panel, const QString &value)
+{
+	DocumentEntry entry;
+	entry.value = value;
+	entries_.insert(panel, entry);
+	order_dirty_ = true;
+}
+
+/**
+ * @brief Remove a panel from the document.
+ * @param[in] panel The panel that is not part of the GUI anymore.
+ */
+void DocumentModel::removePanel(Atomic *panel)
+{
+	if (entries_.remove(panel) > 0)
+		order_dirty_ = true;
+}
+
+/**
+ * @brief Update the INI value of a panel.
+ * @param[in] panel The panel whose value has changed.
+ * @param[in] value The new INI value.
+ */
+void DocumentModel::setValue(Atomic *panel, const QString &value)
+{
+	const auto it( entries_.find(panel) );
+	if (it != entries_.end())
+		it->value = value;
+}
+
+/**
+ * @brief Mark a widget and the panels within it for a visibility check.
+ * @details This is called when a panel shows or hides parts of itself (e. g. a Dropdown
+ * showing the child panels of the selected item). Only panels that are visible within their
+ * section tab contribute to the INI file.
+ * @param[in] widget The widget that was shown or hidden.
+ */
+void DocumentModel::invalidateVisibility(QWidget *widget)
+{
+	if (entries_.isEmpty())
+		return;
+	const auto it( entries_.find(qobject_cast<Atomic *>(widget)) );
+	if (it != entries_.end())
+		it->visibility_dirty = true;
+	const QList<Atomic *> children( widget->findChildren<Atomic *>() );
+	for (auto &child : children) {
+		const auto child_it( entries_.find(child) );
+		if (child_it != entries_.end())
+			child_it->visibility_dirty = true;
+	}
+}
+
+/**
+ * @brief Check if a widget is the page of a section tab.
+ * @param[in] widget The widget to check.
+ * @return True if the widget is displayed as a section tab.
+ */
+bool DocumentModel::isSectionPage(const QWidget *widget) const
+{
+	//the pages of a QTabWidget are children of its internal QStackedWidget:
+	return (section_tabs_ != nullptr && widget->parentWidget() != nullptr &&
+	    widget->parentWidget()->parentWidget() == section_tabs_);
+}
+
+/**
+ * @brief Add an XML element whose panels are not built yet.
+ * @details Section tabs and the rows of large sections are built when they are first needed.
+ * Until then, their values are given by the XML (or they are empty if the GUI was cleared
+ * without defaults), so they can be written to INI files without building them.
+ * @param[in] anchor The empty group the element will be built into. It gives the position in the GUI.
+ * @param[in] node The XML node of the frame or panel.
+ * @param[in] section The section the node will be built for.
+ * @param[in] shows_defaults True if the panels would show their default values when built.
+ */
+void DocumentModel::addUnbuiltNode(Atomic *anchor, const QDomNode &node, const QString &section,
+    const bool &shows_defaults)
+{
+	UnbuiltEntry &entry( unbuilt_[anchor] );
+	entry.nodes.push_back(qMakePair(node, section));
+	entry.shows_defaults = shows_defaults;
+	order_dirty_ = true;
+}
+
+/**
+ * @brief Remove the XML elements of a group, e. g. because they are being built.
+ * @param[in] anchor The group the elements are built into.
+ */
+void DocumentModel::removeUnbuilt(Atomic *anchor)
+{
+	if (unbuilt_.remove(anchor) > 0)
+		order_dirty_ = true;
+}
+
+/**
+ * @brief Set whether XML elements that are not built yet contribute their default values.
+ * @param[in] anchor The group the elements will be built into.
+ * @param[in] shows_defaults True if the panels would show their default values when built.
+ */
+void DocumentModel::setUnbuiltDefaults(Atomic *anchor, const bool &shows_defaults)
+{
+	const auto it( unbuilt_.find(anchor) );
+	if (it != unbuilt_.end())
+		it->shows_defaults = shows_defaults;
+}
+
+/**
+ * @brief Get the INI keys of all panels that are not built yet.
+ * @details Keys of child panels are included whether or not they would be shown.
+ * @return List of sections and keys.
+ */
+QList<QPair<QString, QString>> DocumentModel::getUnbuiltKeys() const
+{
+	QList<QPair<QString, QString>> keys;
+	for (auto &entry : unbuilt_) {
+		for (auto &node : entry.nodes)
+			collectKeys(node.first.toElement(), node.second, QStringList(), keys);
+	}
+	return keys;
+}
+
+/**
+ * @brief Write all visible panels' values to an INIParser.
+ * @details This is the model's equivalent of running through all panels of all section tabs.
+ * Only panels that are visible within their section tab are taken into account, i. e. the
+ * child panels of unselected Dropdown items or unchecked Checklist items are skipped.
+ * Parts of the GUI that are not built yet are written from their XML.
+ * @param[in] ini The INIParser to set the values in.
+ * @param[in] with_unbuilt Also write the parts of the GUI that are not built yet. If not, the values
+ * that are in the INIParser already are kept for them.
+ * @return Comma separated list of mandatory keys that are not set.
+ */
+QString DocumentModel::serialize(INIParser *ini, const bool &with_unbuilt)
+{
+	if (structure_dirty_) {
+		for (auto &entry : entries_)
+			entry.visibility_dirty = true;
+		order_dirty_ = true;
+		structure_dirty_ = false;
+	}
+	updateOrder();
+
+	QString missing;
+	for (auto &panel : ordered_panels_) {
+		const auto unbuilt_it( unbuilt_.constFind(panel) );
+		if (with_unbuilt && unbuilt_it != unbuilt_.constEnd()) {
+			for (auto &node : unbuilt_it->nodes)
+				serializeElement(node.first.toElement(), node.second, QStringList(),
+				    unbuilt_it->shows_defaults, ini, missing);
+		}
+		const auto entry_it( entries_.find(panel) );
+		if (entry_it == entries_.end()) //group that is not built yet
+			continue;
+		DocumentEntry &entry( *entry_it );
+		if (entry.visibility_dirty)
+			updateVisibility(panel, entry);
+		if (!entry.counted || panel->property("no_ini").toBool())
+			continue;
+		QString section, key;
+		(void) panel->getIniValue(section, key);
+		if (key.isNull()) //GUI element that is not an interactive panel
+			continue;
+
+		const bool is_mandatory = panel->property("is_mandatory").toBool();
+		if (is_mandatory && entry.value.isEmpty()) //collect missing non-optional keys
+			missing += key + ", ";
+		if (!entry.value.isEmpty())
+			ini->set(section, key, entry.value, is_mandatory);
+	}
+	missing.chop(2); //trailing ", "
+	return missing;
+}
+
+/**
+ * @brief Get the values of all panels, including the ones that are hidden.
+ * @details This is what an INI document keeps while another one is displayed, so that the panels
+ * can be set to its values again without going through an INI file. Panels that create child
+ * panels from their key (Replicator, Selector) are left out since their children have keys
+ * of their own.
+ * @return The panels, their INI keys and values in the order they appear in the GUI.
+ */
+std::vector<StoredValue> DocumentModel::getValues()
+{
+	if (structure_dirty_) //the order is only needed here, visibility is not
+		order_dirty_ = true;
+	updateOrder();
+	std::vector<StoredValue> values;
+	values.reserve(ordered_panels_.size());
+	for (auto &panel : ordered_panels_) {
+		const auto entry_it( entries_.constFind(panel) );
+		if (entry_it == entries_.constEnd() || panel->property("no_ini").toBool())
+			continue;
+		const QString ini_key( panel->getRegisteredKey() );
+		if (KeyTemplateTrie::hasWildcard(ini_key))
+			continue;
+		StoredValue stored;
+		stored.panel = panel;
+		stored.ini_key = ini_key;
+		stored.value = entry_it->value;
+		values.push_back(stored);
+	}
+	return values;
+}
+
+/**
+ * @brief Check if a panel is visible within its section tab.
+ * @details This is what QWidget::isVisibleTo() does for the section tab, but the tab does
+ * not have to be known beforehand.
+ * @param[in] panel The panel to check.
+ * @param[out] entry The panel's entry in the model.
+ */
+void DocumentModel::updateVisibility(Atomic *panel, DocumentEntry &entry) const
+{
+	entry.counted = false;
+	bool is_hidden = false;
+	for (const QWidget *widget = panel; widget != nullptr; widget = widget->parentWidget()) {
+		if (isSectionPage(widget)) {
+			entry.counted = !is_hidden;
+			break;
+		}
+		is_hidden = is_hidden || widget->isHidden();
+	}
+	entry.visibility_dirty = false;
+}
+
+/**
+ * @brief Sort the panels in the order they are displayed in.
+ * @details Panels are created (or moved to their parents) in the order of the XML, so each
+ * panel's position is given by the creation stamps of its chain of parents.
+ */
+void DocumentModel::updateOrder()
+{
+	if (!order_dirty_)
+		return;
+	std::vector<std::pair<std::vector<quint64>, Atomic *>> positions;
+	positions.reserve(static_cast<size_t>(entries_.size() + unbuilt_.size()));
+	const auto add_position = [&positions](Atomic *panel, const bool &after_children) {
+		std::vector<quint64> chain;
+		for (const QWidget *widget = panel; widget != nullptr; widget = widget->parentWidget()) {
+			if (const auto *atomic = qobject_cast<const Atomic *>(widget))
+				chain.push_back(atomic->getTreeOrder());
+		}
+		std::reverse(chain.begin(), chain.end()); //outermost parent first
+		if (after_children) //unbuilt elements are appended to what is in the group already
+			chain.push_back(std::numeric_limits<quint64>::max());
+		positions.emplace_back(std::move(chain), panel);
+	};
+	for (auto it = entries_.begin(); it != entries_.end(); ++it)
+		add_position(it.key(), false);
+	for (auto it = unbuilt_.begin(); it != unbuilt_.end(); ++it) {
+		if (!entries_.contains(it.key()))
+			add_position(it.key(), true);
+	}
+	std::sort(positions.begin(), positions.end(),
+	    [](const std::pair<std::vector<quint64>, Atomic *> &lhs,
+	    const std::pair<std::vector<quint64>, Atomic *> &rhs) { return lhs.first < rhs.first; });
+
+	ordered_panels_.clear();
+	ordered_panels_.reserve(positions.size());
+	for (auto &position : positions)
+		ordered_panels_.push_back(position.second);
+	order_dirty_ = false;
+}
+
+/**
+ * @brief Write the values of the frames and panels below an XML element that is not built yet.
+ * @details This follows recursiveBuild(): only frames and panels that are built for the section
+ * are taken into account.
+ * @param[in] parent The parent XML node.
+ * @param[in] section The section the panels are built for.
+ * @param[in] substitutions Parent keys replacing the "@" placeholders in the keys, outermost first.
+ * @param[in] shows_defaults True if the panels would show their default values.
+ * @param[in] ini The INIParser to set the values in.
+ * @param[out] missing Mandatory keys that are not set are appended here.
+ */
+void DocumentModel::serializeChildren(const QDomNode &parent, const QString &section,
+    const QStringList &substitutions, const bool &shows_defaults, INIParser *ini, QString &missing) const
+{
+	for (QDomElement element = parent.firstChildElement(); !element.isNull(); element = element.nextSiblingElement()) {
+		if (element.tagName() != "frame" && element.tagName() != "parameter")
+			continue;
+		QStringList section_list;
+		if (parseAvailableSections(element, section, section_list))
+			serializeElement(element, section, substitutions, shows_defaults, ini, missing);
+	}
+}
+
+/**
+ * @brief Write the values of a frame or panel that is not built yet.
+ * @details The value is the one the panel would show after being built, i. e. its default value
+ * declared in the XML (or nothing if the GUI was cleared without defaults). Child panels are
+ * followed if they would be shown for this value, like the ones of the selected Dropdown item.
+ * Dynamic panels (Replicator, Selector) start out without children and are skipped.
+ * @param[in] element The XML element of the frame or panel.
+ * @param[in] section The section the panel is built for.
+ * @param[in] substitutions Parent keys replacing the "@" placeholders in the keys, outermost first.
+ * @param[in] shows_defaults True if the panel would show its default value.
+ * @param[in] ini The INIParser to set the values in.
+ * @param[out] missing Mandatory keys that are not set are appended here.
+ */
+void DocumentModel::serializeElement(const QDomElement &element, const QString &section,
+    const QStringList &substitutions, const bool &shows_defaults, INIParser *ini, QString &missing) const
+{
+	if (element.tagName() == "frame") {
+		serializeChildren(element, section, substitutions, shows_defaults, ini, missing);
+		return;
+	}
+	const QString type( element.attribute("type").toLower() );
+	if (element.attribute("template").toLower() == "true" || element.attribute("replicate").toLower() == "true" ||
+	    type == "selector")
+		return;
+	const QString key( substituteKey(element.attribute("key"), substitutions) );
+
+	/* default value, which can also be given by the options (like the panels do it) */
+	QString default_value( element.attribute("default") );
+	QString option_defaults;
+	for (QDomElement op = element.firstChildElement(); !op.isNull(); op = op.nextSiblingElement()) {
+		if ((op.tagName() != "option" && op.tagName() != "o") || op.attribute("default").toLower() != "true")
+			continue;
+		if (type == "alternative")
+			option_defaults = op.attribute("value");
+		else if (type == "choice" || type == "checklist")
+			option_defaults += (option_defaults.isEmpty()? "" : " ") + op.attribute("value");
+	}
+	if (!option_defaults.isEmpty())
+		default_value = option_defaults;
+	const QString value( shows_defaults? default_value : QString() );
+
+	static const QStringList no_value_types( {"grid", "helptext", "horizontal", "label", "space", "spacer"} );
+	if (!key.isEmpty() && !no_value_types.contains(type) && !key.contains("#") && !key.contains("%") &&
+	    !key.contains("*")) {
+		const bool is_mandatory = (element.attribute("optional") == "false");
+		if (is_mandatory && value.isEmpty())
+			missing += key + ", ";
+		if (!value.isEmpty())
+			ini->set(section, key, value, is_mandatory);
+	}
+
+	/* children of the options that would be shown */
+	QStringList option_substitutions( substitutions );
+	if (substitutesKeys(type))
+		option_substitutions.push_back(key);
+	const QStringList selected( value.split(QRegExp("\\s+"), QString::SkipEmptyParts) );
+	const QString value_lc( value.toLower() );
+	bool first_option = true;
+	for (QDomElement op = element.firstChildElement(); !op.isNull(); op = op.nextSiblingElement()) {
+		if (op.tagName() != "option" && op.tagName() != "o")
+			continue;
+		bool is_shown;
+		if (type == "checkbox") //only a single option
+			is_shown = first_option && (value_lc == "true" || value_lc == "t" || value_lc == "1");
+		else if (type == "alternative")
+			is_shown = hasSectionSpecified(section, op) &&
+			    (QString::compare(op.attribute("value"), value, Qt::CaseInsensitive) == 0);
+		else if (type == "choice" || type == "checklist")
+			is_shown = hasSectionSpecified(section, op) && selected.contains(op.attribute("value"), Qt::CaseInsensitive);
+		else
+			is_shown = (type == "horizontal" || type == "grid") && hasSectionSpecified(section, op);
+		first_option = false;
+		if (is_shown)
+			serializeChildren(op, section, option_substitutions, shows_defaults, ini, missing);
+	}
+	serializeChildren(element, section, substitutions, shows_defaults, ini, missing); //panels following this one
+}
+
+/**
+ * @brief Collect the INI keys of a panel and the frames and panels below it.
+ * @param[in] element The XML element of the frame or panel.
+ * @param[in] section The section the panels are built for.
+ * @param[in] substitutions Parent keys replacing the "@" placeholders in the keys, outermost first.
+ * @param[out] keys The sections and keys that were found.
+ */
+void DocumentModel::collectKeys(const QDomElement &element, const QString &section, const QStringList &substitutions,
+    QList<QPair<QString, QString>> &keys)
+{
+	const QString key( substituteKey(element.attribute("key"), substitutions) );
+	if (element.tagName() == "parameter" && !key.isEmpty() && element.attribute("type").toLower() != "label")
+		keys.push_back(qMakePair(section, key));
+	QStringList option_substitutions( substitutions );
+	if (substitutesKeys(element.attribute("type").toLower()))
+		option_substitutions.push_back(key);
+	for (QDomElement child = element.firstChildElement(); !child.isNull(); child = child.nextSiblingElement()) {
+		if (child.tagName() == "option" || child.tagName() == "o")
+			collectKeys(child, section, option_substitutions, keys);
+		else if (child.tagName() == "frame" || child.tagName() == "parameter")
+			collectKeys(child, section, substitutions, keys);
+	}
+}
+
+/**
+ * @brief Replace the "@" placeholders in a key like the parent panels do when they are built.
+ * @details Each parent replaces the first remaining placeholder (cf. Atomic::substituteKeys()).
+ * @param[in] key The key as given in the XML.
+ * @param[in] substitutions Parent keys, outermost first.
+ * @return The key with placeholders replaced.
+ */
+QString DocumentModel::substituteKey(QString key, const QStringList &substitutions)
+{
+	for (auto &sub : substitutions) {
+		const int idx = key.indexOf("@");
+		if (idx == -1)
+			break;
+		key.replace(idx, 1, sub);
+	}
+	return key;
+}
+
+/**
+ * @brief Check if a panel type replaces the "@" placeholders in the keys of its options' children.
+ * @param[in] type The panel type in lower case.
+ * @return True if the panel substitutes its key for the placeholders.
+ */
+bool DocumentModel::substitutesKeys(const QString &type)
+{
+	return (type == "checklist" || type == "choice" || type == "grid" || type == "horizontal");
+}
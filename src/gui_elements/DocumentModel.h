@@ -0,0 +1,122 @@
+/*****************************************************************************/
+/*  Copyright 2019 WSL Institute for Snow and Avalanche Research  SLF-DAVOS  */
+/*****************************************************************************/
+/* This file is part of INIshell.
+   INIshell is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   INIshell is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with INIshell.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Live model of the INI document that is being edited in the GUI. The panels keep it up to date
+ * with their values and visibility so that it can be written to an INI file without searching
+ * the whole widget tree. Parts of the GUI that are not built yet are represented by their XML.
+ * 2020-05
+ */
+
+#ifndef DOCUMENTMODEL_H
+#define DOCUMENTMODEL_H
+
+#include "src/main/INIParser.h"
+
+#include <QDomNode>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QPointer>
+#include <QString>
+#include <QStringList>
+#include <QWidget>
+
+#include <vector>
+
+class Atomic;
+
+/**
+ * @struct DocumentEntry
+ * @brief State of a single panel in the document model.
+ */
+struct DocumentEntry {
+	QString value; //the panel's current INI value
+	bool counted = false; //panel is visible within its section tab
+	bool visibility_dirty = true; //panel or one of its parents has been shown or hidden
+};
+
+/**
+ * @struct UnbuiltEntry
+ * @brief XML elements that are not built yet, held in the place of the GUI they will be built into.
+ */
+struct UnbuiltEntry {
+	QList<QPair<QDomNode, QString>> nodes; //XML nodes and the sections they are built for
+	bool shows_defaults = true; //false if the GUI was cleared without default values
+};
+
+/**
+ * @struct StoredValue
+ * @brief A panel's value kept for an INI document that is not displayed.
+ */
+struct StoredValue {
+	QPointer<Atomic> panel; //the panel the value belongs to
+	QString ini_key; //the panel's INI key including the section (as registered)
+	QString value;
+};
+
+/**
+ * @struct DocumentValues
+ * @brief The panels' values of an INI document that is not displayed.
+ */
+struct DocumentValues {
+	std::vector<StoredValue> values; //in the order the panels appear in the GUI
+	bool stored = false; //false for documents that have never been displayed
+	bool shows_defaults = true; //panels that are built later show their default values
+};
+
+class DocumentModel {
+	public:
+		static DocumentModel & getShared();
+		void setSectionTabs(const QWidget *section_tabs) { section_tabs_ = section_tabs; }
+		void addPanel(Atomic *panel, const QString &value);
+		void removePanel(Atomic *panel);
+		void setValue(Atomic *panel, const QString &value);
+		void invalidateVisibility(QWidget *widget);
+		void invalidateStructure() noexcept { structure_dirty_ = true; }
+		bool isSectionPage(const QWidget *widget) const;
+		void addUnbuiltNode(Atomic *anchor, const QDomNode &node, const QString &section,
+		    const bool &shows_defaults);
+		void removeUnbuilt(Atomic *anchor);
+		void setUnbuiltDefaults(Atomic *anchor, const bool &shows_defaults);
+		QList<QPair<QString, QString>> getUnbuiltKeys() const;
+		QString serialize(INIParser *ini, const bool &with_unbuilt = true);
+		std::vector<StoredValue> getValues();
+
+	private:
+		DocumentModel() = default;
+		void updateVisibility(Atomic *panel, DocumentEntry &entry) const;
+		void updateOrder();
+		void serializeChildren(const QDomNode &parent, const QString &section, const QStringList &substitutions,
+		    const bool &shows_defaults, INIParser *ini, QString &missing) const;
+		void serializeElement(const QDomElement &element, const QString &section, const QStringList &substitutions,
+		    const bool &shows_defaults, INIParser *ini, QString &missing) const;
+		static void collectKeys(const QDomElement &element, const QString &section, const QStringList &substitutions,
+		    QList<QPair<QString, QString>> &keys);
+		static QString substituteKey(QString key, const QStringList &substitutions);
+		static bool substitutesKeys(const QString &type);
+
+		const QWidget *section_tabs_ = nullptr; //the QTabWidget holding the sections
+		QHash<Atomic *, DocumentEntry> entries_; //all panels with an INI key
+		QHash<Atomic *, UnbuiltEntry> unbuilt_; //XML elements by the (empty) group they will be built into
+		std::vector<Atomic *> ordered_panels_; //panels and unbuilt groups in the order they appear in the GUI
+		bool order_dirty_ = false; //panels have been added or removed
+		bool structure_dirty_ = false; //widgets have been moved to other parents
+};
+
+#endif //DOCUMENTMODEL_H
@@ -22,9 +22,13 @@
 #include "src/main/common.h"
 #include "src/main/inishell.h"
 
+#include <QCompleter>
 #include <QFont>
+#include <QKeyEvent>
+#include <QListView>
 #include <QStringList>
 #include <QTimer>
+#include <QToolTip>
 
 /**
  * @class Dropdown
@@ -103,8 +107,8 @@ int Dropdown::getComboBoxHeight() const
 void Dropdown::clear(const bool &set_default)
 {
 	this->setProperty("clearing", true);
-	this->setProperty("ini_value", ini_value_);
-	this->setProperty("ini_value", set_default? this->property("default_value") : QString());
+	setValue(ini_value_);
+	setValue(set_default? this->property("default_value").toString() : QString());
 }
 
 /**
@@ -131,8 +135,11 @@ void Dropdown::setOptions(const QDomNode &options)
 		Group *dummy_group( new Group(section_, "_dummy_group_" + key_,
 		    false, false, false, true) ); //tight layout
 		container_->addWidget(dummy_group); //empty group is selected on dummy click
+		dummy_group->setVisible(false);
+		item_groups_.push_back(dummy_group);
 		item_strings.push_back(dummy_text);
-		item_help_texts_.push_back(QString());
+		option_nodes_.emplace_back(QDomElement()); //no help for the dummy item
+		indexItem(0);
 	}
 
 	/*
@@ -172,16 +179,16 @@ void Dropdown::setOptions(const QDomNode &options)
 		if (!value.isNull()) //set true item value as tip, optionally followed by item help
 			tooltip.prepend(value + (tooltip.isEmpty()? "" : ": "));
 		dropdown_->setItemData(dropdown_->count() - 1, tooltip, Qt::ToolTipRole);
-		QString item_help( op.firstChildElement("help").text() );
-		if (item_help.isNull())
-			item_help = op.firstChildElement("h").text();
-		item_help_texts_.push_back(item_help);
-		if (!item_help_texts_.back().isNull())
+		option_nodes_.emplace_back(op); //shallow copy of the XML node
+		if (!getItemHelp(dropdown_->count() - 1).isNull())
 			has_child_helptexts_ = true;
 
 
 		auto *item_group( new Group(QString(), QString()) ); //group all elements of this option together
 		container_->addWidget(item_group);
+		item_group->setVisible(false); //shown when the item is selected
+		item_groups_.push_back(item_group);
+		indexItem(dropdown_->count() - 1);
 
 		if (generate_on_the_fly) { //build child panels on user interaction only
 			child_nodes_.emplace_back(op); //cache for building on request later
@@ -214,6 +221,16 @@ void Dropdown::setOptions(const QDomNode &options)
 	dropdown_->setMinimumWidth(getElementTextWidth(item_strings, Cst::tiny, Cst::width_dropdown_max) +
 	    Cst::dropdown_safety_padding);
 
+	if (dropdown_->count() >= Cst::dropdown_filter_min_items) { //type-ahead filtering for long lists
+		if (dropdown_->isEditable()) { //the completer filters its own proxy of the item list
+			dropdown_->completer()->setFilterMode(Qt::MatchContains);
+			dropdown_->completer()->setCaseSensitivity(Qt::CaseInsensitive);
+			dropdown_->completer()->setCompletionMode(QCompleter::PopupCompletion);
+		} else {
+			dropdown_->view()->installEventFilter(this);
+		}
+	}
+
 	//style dummy item italic (I don't know why this is necessary, see notes below):
 	QTimer::singleShot(1, this, &Dropdown::styleTimer);
 }
@@ -225,29 +242,30 @@ void Dropdown::setOptions(const QDomNode &options)
  */
 void Dropdown::itemChanged(int index)
 {
-	QLayout *group_layout( container_->getLayout() );
-	for (int ii = 0; ii < group_layout->count(); ++ii) {
-		//find the group to display and hide all others:
-		auto *group_item( qobject_cast<Group *>(group_layout->itemAt(ii)->widget()) );
-		group_item->setVisible(index == ii);
-		if (ii == index) {
-			//build requested child's node on first demand:
-			if (!child_nodes_.at(static_cast<size_t>(ii)).isNull()) {
-				recursiveBuild(child_nodes_.at(static_cast<size_t>(ii)), group_item, section_);
-				child_nodes_.at(static_cast<size_t>(ii)) = QDomElement(); //set to NULL
-			}
-			//hide the container if the displayed group is empty:
-			container_->setVisible(!group_item->isEmpty());
-		}
+	if (index < 0 || static_cast<size_t>(index) >= item_groups_.size())
+		return;
+	if (shown_group_ != index && shown_group_ != -1) //hide the previously selected item's children
+		item_groups_.at(static_cast<size_t>(shown_group_))->setVisible(false);
+	Group *group_item( item_groups_.at(static_cast<size_t>(index)) );
+	group_item->setVisible(true);
+	shown_group_ = index;
+	//build requested child's node on first demand:
+	if (!child_nodes_.at(static_cast<size_t>(index)).isNull()) {
+		recursiveBuild(child_nodes_.at(static_cast<size_t>(index)), group_item, section_);
+		child_nodes_.at(static_cast<size_t>(index)) = QDomElement(); //set to NULL
 	}
+	//hide the container if the displayed group is empty:
+	container_->setVisible(!group_item->isEmpty());
 
 	QString dropdown_data_text( getCurrentText() ); //underlying INI value when available, text otherwise
 	setDefaultPanelStyles(dropdown_data_text);
 
 	/* display per-item help if available */
-	if (has_child_helptexts_)
+	if (has_child_helptexts_) {
+		const QString item_help( getItemHelp(index) );
 		main_help_->updateText( //switch main help to item help if available
-		    item_help_texts_.at(index).isEmpty()? main_help_->property("main_help").toString() : item_help_texts_.at(index));
+		    item_help.isEmpty()? main_help_->property("main_help").toString() : item_help);
+	}
 
 	QFont select_font( dropdown_->font() );
 	select_font.setItalic(dropdown_data_text == ""); //dummy item of non-editable mode is italic
@@ -272,9 +290,9 @@ void Dropdown::editTextChanged(const QString &text)
 	//the entered text, showing the relation. If this behaviour is changed then onPropertySet()
 	//needs to be modified to display a value found in the INI file.
 
-	int idx = dropdown_->findData(text, Qt::UserRole);
+	int idx = value_index_.value(text, -1);
 	if (idx == -1) //not found in item data - search in captions
-		idx = dropdown_->findText(text);
+		idx = caption_index_.value(text, -1);
 
 	if (idx != -1) { //still not found - set free text
 		dropdown_->setCurrentIndex(idx);
@@ -290,12 +308,12 @@ void Dropdown::editTextChanged(const QString &text)
 
 /**
  * @brief Event listener for changed INI values.
- * @details The "ini_value" property is set when parsing default values and potentially again
+ * @details The panel's value is set via setValue() when parsing default values and potentially again
  * when setting INI keys while parsing a file.
  */
 void Dropdown::onPropertySet()
 {
-	const QString text_to_set( this->property("ini_value").toString() );
+	const QString text_to_set( getRequestedValue() );
 	if (ini_value_ == text_to_set)
 		return;
 
@@ -307,16 +325,17 @@ void Dropdown::onPropertySet()
 		return;
 	}
 	//look for item in the dropdown list and select it:
-	for (int ii = 0; ii < dropdown_->count(); ++ii) {
-		const QString dd_text( dropdown_->itemData(ii, Qt::UserRole).toString().toLower() );
-		if ( (dd_text.toLower() == text_to_set.toLower()) ||
-		    (booleans_only_ && dd_text == "false" && text_to_set == "0") ||
-		    (booleans_only_ && dd_text == "true" && text_to_set == "1") ) {
-			dropdown_->setCurrentIndex(ii);
-			emit itemChanged(ii);
-			return;
-		}
-	} //endfor ii
+	QString lookup_text( text_to_set.toLower() );
+	if (booleans_only_ && text_to_set == "0")
+		lookup_text = "false";
+	else if (booleans_only_ && text_to_set == "1")
+		lookup_text = "true";
+	const int idx = value_index_nocase_.value(lookup_text, -1);
+	if (idx != -1) {
+		dropdown_->setCurrentIndex(idx);
+		emit itemChanged(idx);
+		return;
+	}
 	if (!this->property("clearing").toBool())
 		topLog(tr(R"(Value "%1" could not be set in Alternative panel from INI file for key "%2::%3": no such option specified in XML file)").arg(
 		    text_to_set, section_, key_), "warning");
@@ -333,12 +352,110 @@ void Dropdown::onPropertySet()
  */
 QString Dropdown::getCurrentText() const
 {
-	const int item_idx = dropdown_->findText(dropdown_->currentText()); //case insensitive
+	const int item_idx = caption_index_.value(dropdown_->currentText(), -1);
 	if (item_idx == -1)
 		return dropdown_->currentText();
 	return dropdown_->itemData(item_idx, Qt::UserRole).toString();
 }
 
+/**
+ * @brief Get the help text of a Dropdown item.
+ * @details The help texts stay in the XML (which is shared by all panels built from it) and are
+ * only looked up when an item is selected.
+ * @param[in] index Index of the Dropdown item.
+ * @return The item's help text, or a null string if there is none.
+ */
+QString Dropdown::getItemHelp(const int &index) const
+{
+	if (index < 0 || static_cast<size_t>(index) >= option_nodes_.size())
+		return QString();
+	const QDomElement &op( option_nodes_.at(static_cast<size_t>(index)) );
+	QString item_help( op.firstChildElement("help").text() );
+	if (item_help.isNull())
+		item_help = op.firstChildElement("h").text();
+	return item_help;
+}
+
+/**
+ * @brief Add a Dropdown item to the lookup tables.
+ * @details Values and captions are looked up through hashes instead of searching the list,
+ * which matters for lists with thousands of items. If texts are duplicated the first item wins,
+ * like with QComboBox::findData().
+ * @param[in] index Index of the Dropdown item.
+ */
+void Dropdown::indexItem(const int &index)
+{
+	const QString value( dropdown_->itemData(index, Qt::UserRole).toString() );
+	const QString caption( dropdown_->itemText(index) );
+	if (!value_index_.contains(value))
+		value_index_.insert(value, index);
+	if (!value_index_nocase_.contains(value.toLower()))
+		value_index_nocase_.insert(value.toLower(), index);
+	if (!caption_index_.contains(caption))
+		caption_index_.insert(caption, index);
+	search_texts_.push_back(caption.toLower() + "\n" + value.toLower());
+}
+
+/**
+ * @brief Show only the items of the popup list that contain a text.
+ * @details The items stay in the list, non-matching rows are only hidden.
+ * @param[in] filter Text to search in the items' captions and values (case insensitive).
+ * Show all items if empty.
+ */
+void Dropdown::filterItems(const QString &filter)
+{
+	auto *list_view( qobject_cast<QListView *>(dropdown_->view()) );
+	if (list_view == nullptr)
+		return;
+	const QString filter_lower( filter.toLower() );
+	int first_match = -1;
+	for (size_t ii = 0; ii < search_texts_.size(); ++ii) {
+		const bool match = filter_lower.isEmpty() || search_texts_[ii].contains(filter_lower);
+		list_view->setRowHidden(static_cast<int>(ii), !match);
+		if (match && first_match == -1)
+			first_match = static_cast<int>(ii);
+	}
+	if (first_match != -1) //so that Enter picks the first match
+		list_view->setCurrentIndex(dropdown_->model()->index(first_match, dropdown_->modelColumn()));
+}
+
+/**
+ * @brief Type-ahead filtering in the popup list of long Dropdowns.
+ * @details Typed characters are collected while the popup is open and only the matching items
+ * are shown. Navigation keys are passed on, and so is Space (selecting the current item) unless
+ * a filter is being typed. The filter is reset when the popup closes.
+ * @param[in] object The Dropdown's popup list.
+ * @param[in] event The type of event.
+ * @return True if the event was consumed.
+ */
+bool Dropdown::eventFilter(QObject *object, QEvent *event)
+{
+	if (object == dropdown_->view()) {
+		if (event->type() == QEvent::KeyPress) {
+			const QKeyEvent *key_event = static_cast<QKeyEvent *>(event);
+			const QString typed( key_event->text() );
+			if (key_event->key() == Qt::Key_Backspace && !filter_text_.isEmpty()) {
+				filter_text_.chop(1);
+			} else if (key_event->key() == Qt::Key_Space && filter_text_.isEmpty()) {
+				return QObject::eventFilter(object, event); //space selects the current item
+			} else if (!typed.isEmpty() && typed.at(0).isPrint()) {
+				filter_text_ += typed;
+			} else {
+				return QObject::eventFilter(object, event);
+			}
+			filterItems(filter_text_);
+			QToolTip::showText(dropdown_->view()->mapToGlobal(QPoint(0, 0)), filter_text_, dropdown_->view());
+			return true;
+		}
+		if (event->type() == QEvent::Hide && !filter_text_.isEmpty()) {
+			filter_text_.clear();
+			filterItems(QString());
+			QToolTip::hideText();
+		}
+	}
+	return QObject::eventFilter(object, event);
+}
+
 /**
  * @brief Workaround to set the first dummy item italic if appropriate.
  * @details Styling a QComboBox remains a bit of a mystery (Qt 5.13.5). Some observations:
@@ -29,6 +29,8 @@
 #include "Group.h"
 
 #include <QComboBox>
+#include <QEvent>
+#include <QHash>
 #include <QLineEdit>
 #include <QString>
 #include <QStringList>
@@ -48,13 +50,26 @@ friend class Selector;
 		int getComboBoxHeight() const; //to size panels using the Dropdown
 		void clear(const bool &set_default = true) override;
 
+	protected:
+		bool eventFilter(QObject *object, QEvent *event) override;
+
 	private:
 		void setOptions(const QDomNode &options);
 		QString getCurrentText() const;
 		void styleTimer();
+		QString getItemHelp(const int &index) const;
+		void indexItem(const int &index);
+		void filterItems(const QString &filter);
 
 		std::vector<QDomElement> child_nodes_; //cache for child panels
-		QStringList item_help_texts_;
+		std::vector<QDomElement> option_nodes_; //XML of the items (help texts are read from there)
+		std::vector<Group *> item_groups_; //child panel group of each item
+		std::vector<QString> search_texts_; //lower case caption and value of each item to filter by
+		QHash<QString, int> value_index_; //item value -> index
+		QHash<QString, int> value_index_nocase_; //lower case item value -> index
+		QHash<QString, int> caption_index_; //displayed text -> index
+		QString filter_text_; //type-ahead text while the popup list is open
+		int shown_group_ = -1; //index of the visible child panel group
 		QComboBox *dropdown_ = nullptr;
 		Group *container_ = nullptr;
 		Helptext *main_help_ = nullptr;
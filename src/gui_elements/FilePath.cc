@@ -19,8 +19,11 @@
 #include "FilePath.h"
 #include "Label.h"
 #include "src/main/colors.h"
+#include "src/main/FileStatCache.h"
+#include "src/main/inishell.h"
 #include "src/main/settings.h"
 
+#include <QDir>
 #include <QFileDialog>
 #include <QFileInfo>
 #include <QHBoxLayout>
@@ -74,6 +77,14 @@ FilePath::FilePath(const QString &section, const QString &key, const QDomNode &o
 	path_text_->setPlaceholderText(path_only_? tr("<no path set>") : tr("<no file set>"));
 }
 
+/**
+ * @brief Destructor which stops using the checked path.
+ */
+FilePath::~FilePath()
+{
+	setCheckedPath(QString(), false);
+}
+
 /**
  * @brief Parse options for a file/patch picker from XML.
  * @param[in] options XML node holding the file/path picker.
@@ -108,14 +119,16 @@ void FilePath::setOptions(const QDomNode &options)
 
 /**
  * @brief Event listener for changed INI values.
- * @details The "ini_value" property is set when parsing default values and potentially again
+ * @details The panel's value is set via setValue() when parsing default values and potentially again
  * when setting INI keys while parsing a file.
  */
 void FilePath::onPropertySet()
 {
-	const QString filename( this->property("ini_value").toString() );
-	if (ini_value_ == filename)
+	const QString filename( getRequestedValue() );
+	if (ini_value_ == filename) { //a relative path may still point somewhere else for a new INI file
+		checkPath(filename);
 		return;
+	}
 	path_text_->setText(filename);
 	checkValue(filename);
 }
@@ -123,43 +136,106 @@ void FilePath::onPropertySet()
 /**
  * @brief Perform checks on the selected file name.
  * @details While we always set the file name in the INI (could run on different machines)
- * some integrity checks regarding existence, permissions, ..., are performed here.
+ * some integrity checks regarding existence, permissions, ..., are performed. The file system
+ * is queried in the background and the info label is updated when the result is available.
  * @param[in] filename The chosen file name or path.
  */
 void FilePath::checkValue(const QString &filename)
 {
 	path_text_->setText(filename);
+	checkPath(filename);
+	setDefaultPanelStyles(filename);
+	setIniValue(filename); //the label is just info -> file does not actually have to exist
+}
+
+/**
+ * @brief Start checking a file name in the stat cache and show what is known about it.
+ * @param[in] filename The file name or path as entered.
+ */
+void FilePath::checkPath(const QString &filename)
+{
+	//no file system checks possible for file names, we don't know which path the file belongs to:
+	const bool check_file = !filename_only_ && !filename.trimmed().isEmpty();
+	setCheckedPath(check_file? getAbsolutePath(filename) : QString(), !QDir::isAbsolutePath(filename));
+	updateInfo();
+}
+
+/**
+ * @brief Resolve a path entered in the panel.
+ * @details Relative paths are taken relative to the loaded INI file (or the working directory if
+ * no INI file is loaded), which is where the software reading the INI will look for them.
+ * @param[in] filename The file name or path as entered.
+ * @return The absolute path.
+ */
+QString FilePath::getAbsolutePath(const QString &filename) const
+{
+	if (QDir::isAbsolutePath(filename))
+		return QDir::cleanPath(filename);
+	const QString ini_file( getMainWindow()->getIni()->getFilename() );
+	const QString base_path( ini_file.isEmpty()? QDir::currentPath() : QFileInfo( ini_file ).absolutePath() );
+	return QDir::cleanPath(base_path + "/" + filename);
+}
+
+/**
+ * @brief Switch the path that is checked in the stat cache.
+ * @details The cache calls back when the file changes, or when the INI file's directory changes
+ * for relative paths. The path is then resolved and checked again.
+ * @param[in] absolute_path The new path to check, or an empty string to check none.
+ * @param[in] is_relative The path was entered relative to the INI file.
+ */
+void FilePath::setCheckedPath(const QString &absolute_path, const bool &is_relative)
+{
+	if (absolute_path == checked_path_ && is_relative == checked_relative_)
+		return;
+	FileStatCache &cache( FileStatCache::getShared() );
+	if (!checked_path_.isEmpty())
+		cache.release(checked_path_, this);
+	checked_path_ = absolute_path;
+	checked_relative_ = is_relative;
+	if (!checked_path_.isEmpty())
+		cache.acquire(checked_path_, this, [this]() { checkPath(path_text_->text()); }, is_relative);
+}
+
+/**
+ * @brief Display info about the current file in a label below the text field.
+ * @details If the file properties are not known yet the label stays hidden until the stat cache
+ * reports them.
+ */
+void FilePath::updateInfo()
+{
+	const QString filename( path_text_->text() );
+	FileStat file_info;
+	const bool known = !checked_path_.isEmpty() && FileStatCache::getShared().getStat(checked_path_, file_info);
 	info_text_->setVisible(true);
-	const QFileInfo file_info( filename ); //TODO: Handle paths relative to the loaded INI
 
 	if (filename.isEmpty()) {
 		setUpdatesEnabled(false);
 		info_text_->setVisible(false);
 	} else if (filename.trimmed().isEmpty()) {
 		info_text_->setText(tr("[Empty file name]"));
-	} else if (filename_only_) { //no other checks possible, we don't know which path the file belongs to
+	} else if (filename_only_ || !known) { //no checks possible or not done yet
 		setUpdatesEnabled(false);
 		info_text_->setVisible(false);
-	} else if (io_mode == INPUT && !file_info.exists()) {
+	} else if (io_mode == INPUT && !file_info.exists) {
 		info_text_->setText(path_only_? tr("[Folder does not exist]") : tr("[File does not exist]"));
-	} else if (path_only_ && file_info.isFile()) {
+	} else if (path_only_ && file_info.is_file) {
 		info_text_->setText(tr("[Directory path points to a file]"));
-	} else if (!path_only_ && file_info.isDir()) {
+	} else if (!path_only_ && file_info.is_dir) {
 		info_text_->setText(tr("[File path points to a directory]"));
-	} else if (io_mode == INPUT && file_info.exists() && !file_info.isReadable()) {
+	} else if (io_mode == INPUT && file_info.exists && !file_info.is_readable) {
 		info_text_->setText(tr(
-		    R"([File not readable for current user (owned by "%1")])").arg(file_info.owner()));
-	} else if (io_mode == OUTPUT && file_info.exists() && !file_info.isWritable()) {
+		    R"([File not readable for current user (owned by "%1")])").arg(file_info.owner));
+	} else if (io_mode == OUTPUT && file_info.exists && !file_info.is_writable) {
 		info_text_->setText(tr(
-		    R"([File not writable for current user (owned by "%1")])").arg(file_info.owner()));
-	} else if (io_mode == UNSPECIFIED && file_info.exists() && !file_info.isReadable() && !file_info.isWritable()) {
+		    R"([File not writable for current user (owned by "%1")])").arg(file_info.owner));
+	} else if (io_mode == UNSPECIFIED && file_info.exists && !file_info.is_readable && !file_info.is_writable) {
 		info_text_->setText(tr(
-		    R"([File not accessible for current user (owned by "%1")])").arg(file_info.owner()));
-	} else if (file_info.isExecutable() && !file_info.isDir()) {
+		    R"([File not accessible for current user (owned by "%1")])").arg(file_info.owner));
+	} else if (file_info.is_executable && !file_info.is_dir) {
 		info_text_->setText(tr("[File is an executable]"));
-	} else if (file_info.isSymLink()) {
+	} else if (file_info.is_symlink) {
 		info_text_->setText(tr("[File is a symbolic link]"));
-	} else if (io_mode == OUTPUT && !path_only_ && file_info.exists()) {
+	} else if (io_mode == OUTPUT && !path_only_ && file_info.exists) {
 		info_text_->setText(tr("[File already exists]"));
 	} else if (io_mode == OUTPUT && filename.trimmed() != filename) {
 		info_text_->setText(tr("[File name has leading or trailing whitespaces]"));
@@ -167,9 +243,6 @@ void FilePath::checkValue(const QString &filename)
 		setUpdatesEnabled(false);
 		info_text_->setVisible(false);
 	}
-
-	setDefaultPanelStyles(filename);
-	setIniValue(filename); //the label is just info -> file does not actually have to exist
 	setBufferedUpdatesEnabled(1); //hiding the info text sometimes flickers
 }
 
@@ -179,7 +252,6 @@ void FilePath::checkValue(const QString &filename)
  */
 void FilePath::openFile()
 {
-	path_text_->setProperty("shows_default", "true");
 	QString start_path( getSetting("auto::history::last_panel_path", "path") );
 	if (start_path.isEmpty())
 		start_path = QDir::currentPath();
@@ -200,10 +272,10 @@ void FilePath::openFile()
 	
 	if (!path.isNull()) {
 		setSetting("auto::history::last_panel_path", "path", QFileInfo( path ).absoluteDir().path());
-		//setProperty calls checkValue()
+		//setValue calls checkValue()
 		if (filename_only_)
-			this->setProperty("ini_value", QFileInfo( path ).fileName());
+			setValue(QFileInfo( path ).fileName());
 		else
-			this->setProperty("ini_value", path);
+			setValue(path);
 	}
 }
@@ -39,6 +39,11 @@ class FilePath : public Atomic {
 	public:
 		explicit FilePath(const QString &section, const QString &key, const QDomNode &options,
 		    const bool &no_spacers, QWidget *parent = nullptr);
+		~FilePath() override;
+		FilePath(const FilePath&) = delete;
+		FilePath& operator =(FilePath const&) = delete;
+		FilePath(FilePath&&) = delete;
+		FilePath& operator=(FilePath&&) = delete;
 
 	private:
 		enum input_output_mode { //used for info label only
@@ -47,8 +52,14 @@ class FilePath : public Atomic {
 			OUTPUT
 		};
 		void setOptions(const QDomNode &options);
+		void checkPath(const QString &filename);
+		QString getAbsolutePath(const QString &filename) const;
+		void setCheckedPath(const QString &absolute_path, const bool &is_relative);
+		void updateInfo();
 
 		QString extensions_; //file extension filter
+		QString checked_path_; //absolute path the info label is shown for (in use in the stat cache)
+		bool checked_relative_ = false; //the path was entered relative to the INI file
 		input_output_mode io_mode = UNSPECIFIED;
 		QLineEdit *path_text_ = nullptr;
 		QLabel *info_text_ = nullptr;
@@ -58,35 +58,38 @@ Group::Group(const QString &section, const QString &key, const bool &has_border,
 		layout_ = new QVBoxLayout; //frame is always this
 	box_->setLayout(layout_); //we can add widgets at any time
 
-	QString stylesheet; //set title within box instead of above, colors, rounded borders, frame font
+	/*
+	 * The looks of the different group types (title within box instead of above, colors, rounded
+	 * borders, frame font) are set in the application's stylesheet for the "group_style" property.
+	 * Only XML-defined colors need a stylesheet of their own.
+	 */
+	QString custom_style;
 	if (!is_frame) { //normal group
 		if (has_border) {
-			stylesheet = "QGroupBox#_primary_" + getQtKey(getId()) + " {border: 1px solid " +
-			    colors::getQColor("groupborder").name() + "; border-radius: 6px";
+			box_->setProperty("group_style", "border");
 			setLayoutMargins(layout_);
 		} else {
-			stylesheet = "QGroupBox#_primary_" + getQtKey(getId()) + " {border: none; margin-top: 0px";
+			box_->setProperty("group_style", "plain");
 			layout_->setContentsMargins(5, 5, 5, 5);
 		}
 	} else { //it's a frame
-		QString frame_color( in_frame_color ); //pick default frame and frame title color if not given
-		if (frame_color.isNull())
-			frame_color = colors::getQColor("frameborder").name();
-		else
-			frame_color = colors::getQColor(frame_color).name();
-		stylesheet = "QGroupBox::title#_primary_" + getQtKey(getId()) +
-		    " {subcontrol-origin: margin; left: 17px; padding: 0px 5px 0px 5px}" +
-		    "QGroupBox#_primary_" + getQtKey(getId()) + "  {border: 2px solid " +
-		    frame_color + "; border-radius: 6px; margin-top: 8px; color: " + frame_color;
+		box_->setProperty("group_style", "frame");
+		if (!in_frame_color.isNull()) { //the default frame and frame title color is in the stylesheet
+			const QString frame_color( colors::getQColor(in_frame_color).name() );
+			custom_style = "border-color: " + frame_color + "; color: " + frame_color + "; ";
+		}
 		layout_->setContentsMargins(Cst::frame_left_margin, Cst::frame_top_margin, //a little room for the frame
 		    Cst::frame_right_margin, Cst::frame_bottom_margin);
 	}
 	//QTBUG: Note that there's a bug in the "Fusion" GTK style which does not hide empty QGroupBox titles,
 	//hence the coloring may extend above a little if we're not careful.
 	if (!background_color.isNull())
-		stylesheet += "; background-color: " + colors::getQColor(background_color).name();
-	stylesheet += "}";
-	box_->setStyleSheet(stylesheet);
+		custom_style += "background-color: " + colors::getQColor(background_color).name();
+	if (!custom_style.isEmpty()) { //by object name, so that child groups are not affected
+		static int styled_group_count = 0;
+		box_->setObjectName("_styled_group_" + QString::number(++styled_group_count));
+		box_->setStyleSheet("QGroupBox#" + box_->objectName() + " {" + custom_style + "}");
+	}
 	if (tight)
 		layout_->setContentsMargins(0, 0, 0, 0);
 
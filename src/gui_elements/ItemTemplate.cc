@@ -0,0 +1,159 @@
+/*****************************************************************************/
+/*  Copyright 2019 WSL Institute for Snow and Avalanche Research  SLF-DAVOS  */
+/*****************************************************************************/
+/* This file is part of INIshell.
+   INIshell is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   INIshell is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with INIshell.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ItemTemplate.h"
+#include "src/main/constants.h"
+
+/**
+ * @class ItemTemplate
+ * @brief Destructor for an item template, deleting the pooled items.
+ * @details Items in the pool have no parent widget, so nobody else will delete them.
+ */
+ItemTemplate::~ItemTemplate()
+{
+	for (auto *item : pool_)
+		delete item;
+}
+
+/**
+ * @brief Prepare a template for fast instantiation.
+ * @details The template is copied once and put in an artificial parent node, and all places that
+ * need substitutions are looked up. Instantiating it then only takes a copy of the prepared node
+ * and setting the attributes that actually change.
+ * @param[in] templ The XML node of the template panel.
+ * @param[in] placeholder The character to substitute, e. g. "#" for a Replicator.
+ * @param[in] disable_attribute Attribute marking the template as such, it is set to "false" so
+ * that the instances are built as normal panels.
+ */
+void ItemTemplate::compile(const QDomNode &templ, const QString &placeholder, const QString &disable_attribute)
+{
+	doc_ = QDomDocument();
+	root_ = doc_.createElement("dummy_parent");
+	doc_.appendChild(root_);
+	root_.appendChild(doc_.importNode(templ, true));
+	root_.firstChildElement().setAttribute(disable_attribute, "false");
+	placeholder_ = placeholder;
+	substitutions_.clear();
+	std::vector<int> path;
+	findSubstitutions(root_, path);
+}
+
+/**
+ * @brief Create the XML for a new item.
+ * @details This substitutes the placeholder exactly like Atomic::substituteKeys() does, i. e. only
+ * the first occurrence is replaced and nested templates keep the rest.
+ * @param[in] replace_with Text to replace the placeholder with (the item's number or parameter).
+ * @return XML node with the artificial parent to run the GUI building recursion on.
+ */
+QDomNode ItemTemplate::instantiate(const QString &replace_with) const
+{
+	const QDomNode node( root_.cloneNode(true) );
+	for (auto &sub : substitutions_) {
+		QDomElement element( node.toElement() );
+		for (auto idx : sub.path) {
+			element = element.firstChildElement();
+			for (int ii = 0; ii < idx; ++ii)
+				element = element.nextSiblingElement();
+		}
+		QString key( sub.key );
+		key.replace(key.indexOf(placeholder_), 1, replace_with);
+		QString caption( sub.caption );
+		caption.replace(key.indexOf(placeholder_), 1, replace_with);
+		QString label( sub.label );
+		label.replace(label.indexOf(placeholder_), 1, replace_with);
+		element.setAttribute("key", key);
+		element.setAttribute("caption", caption);
+		element.setAttribute("label", label);
+	}
+	return node;
+}
+
+/**
+ * @brief Get an item that was built for a token before and is not in use anymore.
+ * @param[in] token The item's number or parameter.
+ * @return The item (ready to be added to the GUI again), or null if there is none.
+ */
+Group * ItemTemplate::takeItem(const QString &token)
+{
+	Group *item( pool_.take(token) );
+	if (item != nullptr)
+		setRegistered(item, true);
+	return item;
+}
+
+/**
+ * @brief Keep an item that is removed from the GUI to reuse it later.
+ * @details The item's panels are reset to their defaults (which recycles nested dynamic panels'
+ * items as well) and are taken out of the key registry. The pool is limited in size, beyond that
+ * the item is deleted.
+ * @param[in] token The item's number or parameter.
+ * @param[in] item The item to recycle.
+ */
+void ItemTemplate::recycleItem(const QString &token, Group *item)
+{
+	if (pool_.size() >= Cst::template_pool_size || pool_.contains(token)) {
+		item->erase(); //delete the group's children
+		delete item; //delete the group itself
+		return;
+	}
+	const QList<Atomic *> panel_list( item->findChildren<Atomic *>() );
+	for (auto &panel : panel_list)
+		panel->clear();
+	setRegistered(item, false);
+	item->setParent(nullptr); //leave the GUI (and the parent's layout)
+	pool_.insert(token, item);
+}
+
+/**
+ * @brief Find the elements of the template whose attributes contain the placeholder.
+ * @param[in] parent_element The element to search the children of.
+ * @param[in] path Child indices leading to parent_element.
+ */
+void ItemTemplate::findSubstitutions(const QDomElement &parent_element, std::vector<int> &path)
+{
+	int idx = 0;
+	for (QDomElement element = parent_element.firstChildElement(); !element.isNull();
+	    element = element.nextSiblingElement(), ++idx) {
+		path.push_back(idx);
+		const QString key( element.attribute("key") );
+		const QString label( element.attribute("label") );
+		if (key.contains(placeholder_) || label.contains(placeholder_)) {
+			TemplateSubstitution sub;
+			sub.path = path;
+			sub.key = key;
+			sub.caption = element.attribute("caption");
+			sub.label = label;
+			substitutions_.push_back(sub);
+		}
+		findSubstitutions(element, path);
+		path.pop_back();
+	}
+}
+
+/**
+ * @brief Put all panels of an item into the key registry, or take them out.
+ * @param[in] item The item to (un)register.
+ * @param[in] registered True to register, false to unregister.
+ */
+void ItemTemplate::setRegistered(Group *item, const bool &registered)
+{
+	item->setRegistered(registered);
+	const QList<Atomic *> panel_list( item->findChildren<Atomic *>() );
+	for (auto &panel : panel_list)
+		panel->setRegistered(registered);
+}
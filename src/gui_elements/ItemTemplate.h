@@ -0,0 +1,72 @@
+/*****************************************************************************/
+/*  Copyright 2019 WSL Institute for Snow and Avalanche Research  SLF-DAVOS  */
+/*****************************************************************************/
+/* This file is part of INIshell.
+   INIshell is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   INIshell is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with INIshell.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Compiled XML template of the child panels of a Replicator or Selector, and a pool of
+ * built items to reuse when an item is added again.
+ * 2020-05
+ */
+
+#ifndef ITEMTEMPLATE_H
+#define ITEMTEMPLATE_H
+
+#include "Group.h"
+
+#include <QDomDocument>
+#include <QDomElement>
+#include <QHash>
+#include <QString>
+
+#include <vector>
+
+/**
+ * @struct TemplateSubstitution
+ * @brief An element of a template whose attributes contain the placeholder.
+ */
+struct TemplateSubstitution {
+	std::vector<int> path; //child element indices leading from the template root to the element
+	QString key; //original attribute values
+	QString caption;
+	QString label;
+};
+
+class ItemTemplate {
+	public:
+		ItemTemplate() = default;
+		~ItemTemplate();
+		ItemTemplate(const ItemTemplate&) = delete;
+		ItemTemplate& operator =(ItemTemplate const&) = delete;
+		ItemTemplate(ItemTemplate&&) = delete;
+		ItemTemplate& operator=(ItemTemplate&&) = delete;
+		void compile(const QDomNode &templ, const QString &placeholder, const QString &disable_attribute);
+		QDomNode instantiate(const QString &replace_with) const;
+		Group * takeItem(const QString &token);
+		void recycleItem(const QString &token, Group *item);
+
+	private:
+		void findSubstitutions(const QDomElement &parent_element, std::vector<int> &path);
+		static void setRegistered(Group *item, const bool &registered);
+
+		QDomDocument doc_; //owns the prepared template
+		QDomElement root_; //artificial parent of the template (for the recursion)
+		QString placeholder_; //character that is substituted, e. g. "#"
+		std::vector<TemplateSubstitution> substitutions_;
+		QHash<QString, Group *> pool_; //token -> built item that is not in use
+};
+
+#endif //ITEMTEMPLATE_H
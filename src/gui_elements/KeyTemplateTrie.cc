@@ -0,0 +1,169 @@
+/*****************************************************************************/
+/*  Copyright 2019 WSL Institute for Snow and Avalanche Research  SLF-DAVOS  */
+/*****************************************************************************/
+/* This file is part of INIshell.
+   INIshell is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   INIshell is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with INIshell.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "KeyTemplateTrie.h"
+
+#include <algorithm>
+
+/*
+ * Template keys contain wildcards that are substituted when a dynamic panel creates a child:
+ * "#" stands for a number (Replicator), "%" for a parameter name (Selector). Each wildcard
+ * consumes the whole run of digits resp. parameter characters of an INI key, so a key is
+ * matched against all templates in a single pass.
+ */
+static const QChar wildcard_number('#');
+static const QChar wildcard_parameter('%');
+
+/**
+ * @class KeyTemplateTrie
+ * @brief Add a dynamic panel's template key.
+ * @param[in] pattern The template key in lower case.
+ * @param[in] panel The panel that can create children from the template.
+ */
+void KeyTemplateTrie::insert(const QString &pattern, Atomic *panel)
+{
+	size_t node_index = 0;
+	for (const QChar &cc : pattern) {
+		const auto it( nodes_[node_index].children.constFind(cc) );
+		if (it == nodes_[node_index].children.constEnd()) {
+			nodes_.emplace_back();
+			nodes_[node_index].children.insert(cc, nodes_.size() - 1);
+			node_index = nodes_.size() - 1;
+		} else {
+			node_index = it.value();
+		}
+	}
+	if (!nodes_[node_index].panels.contains(panel))
+		nodes_[node_index].panels.push_back(panel);
+}
+
+/**
+ * @brief Remove a dynamic panel's template key.
+ * @details Nodes are kept since the next application usually has the same templates.
+ * @param[in] pattern The template key in lower case.
+ * @param[in] panel The panel to remove.
+ */
+void KeyTemplateTrie::remove(const QString &pattern, Atomic *panel)
+{
+	size_t node_index = 0;
+	for (const QChar &cc : pattern) {
+		const auto it( nodes_[node_index].children.constFind(cc) );
+		if (it == nodes_[node_index].children.constEnd())
+			return;
+		node_index = it.value();
+	}
+	nodes_[node_index].panels.removeOne(panel);
+}
+
+/**
+ * @brief Find the dynamic panels that could create the panel for an INI key.
+ * @details If several templates fit (e. g. "FILTERS::%::FILTER#" and "FILTERS::TA::FILTER#" for
+ * "FILTERS::TA::FILTER1"), the one with the longest fixed part comes first since it is the one
+ * that was already created for the parameter.
+ * @param[in] key The INI key including the section (case insensitive).
+ * @return All fitting panels, the most specific one first.
+ */
+std::vector<KeyTemplateMatch> KeyTemplateTrie::match(const QString &key) const
+{
+	std::vector<KeyTemplateMatch> matches;
+	matchNode(0, key, 0, 0, KeyTemplateMatch(), matches);
+	std::stable_sort(matches.begin(), matches.end(), [](const KeyTemplateMatch &lhs, const KeyTemplateMatch &rhs) {
+		return lhs.prefix_length > rhs.prefix_length;
+	});
+	return matches;
+}
+
+/**
+ * @brief Check if a key is a template key.
+ * @param[in] key The key to check.
+ * @return True if the key contains a wildcard.
+ */
+bool KeyTemplateTrie::hasWildcard(const QString &key)
+{
+	return key.contains(wildcard_number) || key.contains(wildcard_parameter);
+}
+
+/**
+ * @brief Walk the tree for an INI key.
+ * @param[in] node_index The current node.
+ * @param[in] key The INI key to match.
+ * @param[in] pos The current position within the INI key.
+ * @param[in] depth The current position within the template key.
+ * @param[in] current The match collected so far (empty token as long as no wildcard was passed).
+ * @param[out] matches Found matches are appended here.
+ */
+void KeyTemplateTrie::matchNode(const size_t &node_index, const QString &key, const int &pos, const int &depth,
+    const KeyTemplateMatch &current, std::vector<KeyTemplateMatch> &matches) const
+{
+	const Node &node( nodes_[node_index] );
+	if (pos == key.length()) {
+		if (current.token.isEmpty()) //not a template key
+			return;
+		for (auto *panel : node.panels) { //template keys ending here
+			KeyTemplateMatch found( current );
+			found.panel = panel;
+			matches.push_back(found);
+		}
+		return;
+	}
+
+	const auto literal( node.children.constFind(key.at(pos).toLower()) );
+	if (literal != node.children.constEnd())
+		matchNode(literal.value(), key, pos + 1, depth + 1, current, matches);
+
+	const auto number( node.children.constFind(wildcard_number) );
+	if (number != node.children.constEnd()) {
+		int end = pos;
+		while (end < key.length() && key.at(end).isDigit())
+			++end;
+		if (end > pos) {
+			KeyTemplateMatch next( current );
+			if (next.token.isEmpty()) { //only the first wildcard is substituted by the panel
+				next.token = key.mid(pos, end - pos);
+				next.prefix_length = depth;
+			}
+			matchNode(number.value(), key, end, depth + 1, next, matches);
+		}
+	}
+
+	const auto parameter( node.children.constFind(wildcard_parameter) );
+	if (parameter != node.children.constEnd()) {
+		int end = pos;
+		while (end < key.length() && isParameterChar(key.at(end)))
+			++end;
+		if (end > pos) {
+			KeyTemplateMatch next( current );
+			if (next.token.isEmpty()) {
+				next.token = key.mid(pos, end - pos);
+				next.prefix_length = depth;
+			}
+			matchNode(parameter.value(), key, end, depth + 1, next, matches);
+		}
+	}
+}
+
+/**
+ * @brief Check if a character can be part of a parameter name.
+ * @param[in] cc The character to check.
+ * @return True for word characters and "*", "-", ".".
+ */
+bool KeyTemplateTrie::isParameterChar(const QChar &cc)
+{
+	return cc.isLetterOrNumber() || cc == '_' || cc == '*' || cc == '-' || cc == '.';
+}
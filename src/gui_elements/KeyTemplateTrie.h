@@ -0,0 +1,68 @@
+/*****************************************************************************/
+/*  Copyright 2019 WSL Institute for Snow and Avalanche Research  SLF-DAVOS  */
+/*****************************************************************************/
+/* This file is part of INIshell.
+   INIshell is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   INIshell is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with INIshell.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*
+ * Prefix tree of the template keys of dynamic panels (Replicator, Selector) to find the
+ * panel that can create the panel for an INI key.
+ * 2020-05
+ */
+
+#ifndef KEYTEMPLATETRIE_H
+#define KEYTEMPLATETRIE_H
+
+#include <QChar>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+#include <vector>
+
+class Atomic;
+
+/**
+ * @struct KeyTemplateMatch
+ * @brief A dynamic panel whose template key fits an INI key.
+ */
+struct KeyTemplateMatch {
+	Atomic *panel = nullptr;
+	QString token; //what the first wildcard stands for, i. e. the value to set for the panel
+	int prefix_length = 0; //number of literal characters before the first wildcard
+};
+
+class KeyTemplateTrie {
+	public:
+		KeyTemplateTrie() : nodes_(1) {}
+		void insert(const QString &pattern, Atomic *panel);
+		void remove(const QString &pattern, Atomic *panel);
+		std::vector<KeyTemplateMatch> match(const QString &key) const;
+		static bool hasWildcard(const QString &key);
+
+	private:
+		struct Node {
+			QHash<QChar, size_t> children; //lower case characters and wildcards -> node index
+			QList<Atomic *> panels; //dynamic panels whose template key ends here
+		};
+		void matchNode(const size_t &node_index, const QString &key, const int &pos, const int &depth,
+		    const KeyTemplateMatch &current, std::vector<KeyTemplateMatch> &matches) const;
+		static bool isParameterChar(const QChar &cc);
+
+		std::vector<Node> nodes_; //the root is at index 0
+};
+
+#endif //KEYTEMPLATETRIE_H
@@ -17,7 +17,6 @@
 */
 
 #include "Number.h"
-#include "src/main/colors.h"
 #include "src/main/expressions.h"
 #include "src/main/inishell.h"
 
@@ -54,13 +53,11 @@ bool KeyPressFilter::eventFilter(QObject *object, QEvent *event)
 				 */
 				object->setProperty("empty", "false"); //necessary if entered number happens to be the hidden value
 				if (auto *spinbox = qobject_cast<QSpinBox *>(object)) { //try both types
-					spinbox->parent()->setProperty("ini_value", key_event->key() - Qt::Key_0);
-					spinbox->style()->unpolish(spinbox);
-					spinbox->style()->polish(spinbox);
+					qobject_cast<Atomic *>(spinbox->parent())->setValue(key_event->key() - Qt::Key_0);
+					Atomic::repolish(spinbox);
 				} else if (auto *spinbox = qobject_cast<QDoubleSpinBox *>(object)) {
-					spinbox->parent()->setProperty("ini_value", key_event->key() - Qt::Key_0);
-					spinbox->style()->unpolish(spinbox);
-					spinbox->style()->polish(spinbox);
+					qobject_cast<Atomic *>(spinbox->parent())->setValue(key_event->key() - Qt::Key_0);
+					Atomic::repolish(spinbox);
 				}
 				return true; //we have already input the value - prevent 2nd time
 			} //endif property
@@ -117,14 +114,17 @@ Number::Number(const QString &section, const QString &key, const QDomNode &optio
 	connect(switch_button_, &QToolButton::toggled, this, &Number::switchToggle);
 	switch_button_->setAutoRaise(true);
 	switch_button_->setCheckable(true);
-	switch_button_->setStyleSheet("QToolButton:checked {background-color: " +
-	    colors::getQColor("number").name() + "}");
+	switch_button_->setProperty("expression_switch", "true"); //colored in the application's stylesheet
 	switch_button_->setIcon(getIcon("displaymathmode"));
 	switch_button_->setToolTip(tr("Enter an expression such as ${other_ini_key}, ${env:my_env_var} or ${{arithm. expression}}"));
 
 	switcher_layout_ = new QHBoxLayout;
 	switcher_layout_->addWidget(number_element_, 0, Qt::AlignLeft);
 	switcher_layout_->addWidget(switch_button_);
+	evaluation_label_ = new QLabel;
+	evaluation_label_->setToolTip(tr("Current value of the expression"));
+	evaluation_label_->hide();
+	switcher_layout_->addWidget(evaluation_label_);
 	if (options.toElement().attribute("notoggle").toLower() == "true")
 		switch_button_->hide();
 
@@ -152,6 +152,7 @@ Number::Number(const QString &section, const QString &key, const QDomNode &optio
  */
 Number::~Number()
 {
+	expr::ExpressionGraph::getShared().removeDependent(this); //its callback refers to this panel
 	delete key_filter_;
 }
 
@@ -210,8 +211,8 @@ void Number::clear(const bool &set_default)
 			switch_button_->animateClick();
 	}
 
-	this->setProperty("ini_value", ini_value_);
-	this->setProperty("ini_value", default_value.isEmpty()? def_number_val : default_value);
+	setValue(ini_value_);
+	setValue(default_value.isEmpty()? def_number_val : default_value);
 	if (default_value.isEmpty()) {
 		setIniValue(QString());
 		QTimer::singleShot(1, this, [=]{ setEmpty(true); });
@@ -299,12 +300,7 @@ void Number::setOptions(const QDomNode &options)
 		    SLOT(checkValue(const int &)));
 	} //endif format
 
-	/* allow to set "empty" via the property system */
-	QString bg_color( colors::getQColor("app_bg").name() );
-	//find font color to use for hidden spinbox text dependent on background color:
-	if (options.toElement().attribute("optional").toLower() == "false")
-		bg_color = colors::getQColor("mandatory").name();
-	number_element_->setStyleSheet("* [empty=\"true\"] {color: " + bg_color + "}");
+	//the "empty" property hides the text (cf. application stylesheet)
 
 	//user-set substitutions in expressions to style custom keys correctly:
 	substitutions_ = expr::parseSubstitutions(options);
@@ -333,9 +329,10 @@ int Number::getPrecisionOfNumber(const QString &str_number) const
  */
 void Number::setEmpty(const bool &is_empty)
 {
+	if (number_element_->property("empty").toBool() == is_empty)
+		return;
 	number_element_->setProperty("empty", is_empty);
-	this->style()->unpolish(number_element_);
-	this->style()->polish(number_element_);
+	repolish(number_element_);
 }
 
 /**
@@ -382,15 +379,39 @@ void Number::checkValue(const int &to_check)
  */
 void Number::checkStrValue(const QString &str_check)
 {
-	bool evaluation_success;
-	setDefaultPanelStyles(str_check);
-
-	if (expr::checkExpression(str_check, evaluation_success, substitutions_) || !evaluation_success)
-		setValidPanelStyle(evaluation_success);
+	styleExpression(str_check);
 	QTimer::singleShot(1, [=]{ setEmpty(false); });
 	setIniValue(str_check); //it is just a hint - save anyway
 }
 
+/**
+ * @brief Style the panel according to the validity of an expression.
+ * @details The expression's syntax tree is kept as long as the text does not change, and the
+ * check is repeated (without parsing again) when an INI key it refers to changes. If the expression
+ * can be evaluated, its value is shown next to it.
+ * @param[in] expression The expression to check.
+ */
+void Number::styleExpression(const QString &expression)
+{
+	setDefaultPanelStyles(expression);
+	expr::ExpressionCheck check( expr::parseExpression(expression, substitutions_, true, &compiled_expression_) );
+	expr::resolveExpression(check);
+	QString value;
+	QStringList evaluated_keys; //also the keys referenced by referenced expressions
+	const bool has_value = check.is_expression && check.evaluation_success &&
+	    expr::previewValue(expression, section_ + Cst::sep + key_, value, evaluated_keys, true,
+	    check.is_compiled? &compiled_expression_ : nullptr); //no need to parse again
+	evaluation_label_->setText(has_value? "= " + value : QString());
+	evaluation_label_->setVisible(has_value);
+	evaluated_keys.append(check.ini_keys);
+	evaluated_keys.removeDuplicates();
+	expr::ExpressionGraph::getShared().setDependencies(this, evaluated_keys, [this]() {
+		styleExpression(expression_element_->text());
+	});
+	if (check.is_expression || !check.evaluation_success)
+		setValidPanelStyle(check.evaluation_success);
+}
+
 /**
  * @brief Check if a string is free text for an expression or a number.
  * @details This function is used to check which mode to enter. Since some keys can have
@@ -408,12 +429,12 @@ bool Number::isNumber(const QString &expression) const
 
 /**
  * @brief Event listener for changed INI values.
- * @details The "ini_value" property is set when parsing default values and potentially again
+ * @details The panel's value is set via setValue() when parsing default values and potentially again
  * when setting INI keys while parsing a file.
  */
 void Number::onPropertySet()
 {
-	const QString str_value( this->property("ini_value").toString() );
+	const QString str_value( getRequestedValue() );
 	if (ini_value_ == str_value)
 		return;
 
@@ -501,8 +522,10 @@ void Number::switchToggle(bool checked)
 		setDefaultPanelStyles(expression_element_->text());
 		checkStrValue(expression_element_->text());
 	} else { //spin box mode
+		expr::ExpressionGraph::getShared().removeDependent(this);
 		switcher_layout_->replaceWidget(expression_element_, number_element_);
 		expression_element_->hide();
+		evaluation_label_->hide();
 		number_element_->show();
 		setPrimaryWidget(number_element_);
 		if (mode_ == NR_DECIMAL) {
@@ -25,9 +25,11 @@
 #define NUMBER_H
 
 #include "Atomic.h"
+#include "src/main/expressions.h"
 
 #include <QAbstractSpinBox>
 #include <QHBoxLayout>
+#include <QLabel>
 #include <QLineEdit>
 #include <QString>
 #include <QToolButton>
@@ -63,12 +65,16 @@ class Number : public Atomic {
 		int getPrecisionOfNumber(const QString &str_number) const;
 		void setEmpty(const bool &is_empty);
 
+		void styleExpression(const QString &expression);
+
 		std::vector<std::pair<QString, QString>> substitutions_; //user-set substitutions to translate to tinyexpr
+		expr::CompiledExpression compiled_expression_; //syntax tree of the current expression
 		KeyPressFilter *key_filter_ = nullptr;
 		QAbstractSpinBox *number_element_ = nullptr;
 		QLineEdit *expression_element_ = nullptr;
 		QHBoxLayout *switcher_layout_ = nullptr;
 		QToolButton *switch_button_ = nullptr;
+		QLabel *evaluation_label_ = nullptr; //shows the value of an expression
 		int default_precision_ = 2;
 		int precision_ = default_precision_; //current precision
 		number_mode mode_;
@@ -19,7 +19,10 @@
 #include "Replicator.h"
 #include "Label.h"
 #include "src/main/inishell.h"
-#include "src/main/XMLReader.h"
+
+#include <QPair>
+
+#include <algorithm>
 
 #ifdef DEBUG
 	#include <QDebug>
@@ -85,7 +88,8 @@ void Replicator::setOptions(const QDomNode &options)
 {
 	templ_ = options; //save a reference to the child XML node (shallow copy)
 	templ_.removeChild(templ_.firstChildElement("help"));
-	this->setObjectName(getQtKey(section_ + Cst::sep + options.toElement().attribute("key")));
+	item_template_.compile(templ_, "#", "replicate"); //build as normal element
+	registerKey(section_ + Cst::sep + options.toElement().attribute("key"), true);
 }
 
 /**
@@ -110,33 +114,80 @@ int Replicator::findLastItemRow() const
 
 /**
  * @brief Event listener for the plus button: replicate the child widget.
- * @details The child was saved as XML node, here this is parsed and built.
+ * @details The child was compiled from XML once, here it is instantiated and built. If an item
+ * with this number existed before it is reused instead.
  */
 void Replicator::replicate(const int &panel_number)
 {
 	setUpdatesEnabled(false);
-	QDomNode node( prependParent(templ_) ); //prepend artificial parent node for recursion (runs through children)
-	node.firstChildElement().setAttribute("replicate", "false"); //set node to normal element to be constructed
-	node.firstChildElement().setAttribute("label", QString("No %1:").arg(panel_number));
-	QDomElement element( node.toElement() );
-
-	//recursively inject the element's number into the childrens' keys:
-	substituteKeys(element, "#", QString::number(panel_number));
-
-	Group *new_group = new Group(section_, "_replicator_item_" + key_);
-	recursiveBuild(node, new_group, section_); //construct the children
-	if (this->property("no_ini").toBool()) {
-		const QList<Atomic *>new_panels( new_group->findChildren<Atomic *>() );
-		for (auto &panel : new_panels)
-			panel->setProperty("no_ini", "true");
+	addItem(panel_number);
+	showItems();
+	setBufferedUpdatesEnabled(1);
+}
+
+/**
+ * @brief Create many child widgets at once.
+ * @details This is used when loading INI files with many numbered keys: instead of replicating
+ * item by item in the order the keys arrive (alphabetically, i. e. 1, 10, 100, 2, ...), all
+ * items are created in numeric order with painting disabled only once. Numbers that already have
+ * an item are skipped.
+ * @param[in] panel_numbers The numbers to create items for.
+ */
+void Replicator::replicateAll(QList<int> panel_numbers)
+{
+	std::sort(panel_numbers.begin(), panel_numbers.end());
+	panel_numbers.erase(std::unique(panel_numbers.begin(), panel_numbers.end()), panel_numbers.end());
+	setUpdatesEnabled(false);
+	Atomic::beginBatchUpdate(); //restyle the new panels only once
+	bool any_added = false;
+	for (auto panel_number : panel_numbers) {
+		if (container_->getGridLayout()->itemAtPosition(panel_number, 0) != nullptr)
+			continue; //already exists
+		addItem(panel_number);
+		any_added = true;
+	}
+	if (any_added)
+		showItems();
+	(void) Atomic::endBatchUpdate();
+	setBufferedUpdatesEnabled(1);
+}
+
+/**
+ * @brief Build a child widget for a number and put it in its place.
+ * @param[in] panel_number The number to inject into the child's keys.
+ */
+void Replicator::addItem(const int &panel_number)
+{
+	const QString token( QString::number(panel_number) );
+	Group *new_group( item_template_.takeItem(token) );
+	const bool recycled = (new_group != nullptr);
+	if (!recycled) {
+		//inject the element's number into the childrens' keys:
+		QDomNode node( item_template_.instantiate(token) );
+		node.firstChildElement().setAttribute("label", QString("No %1:").arg(panel_number));
+		new_group = new Group(section_, "_replicator_item_" + key_);
+		recursiveBuild(node, new_group, section_); //construct the children
+		if (this->property("no_ini").toBool()) {
+			const QList<Atomic *>new_panels( new_group->findChildren<Atomic *>() );
+			for (auto &panel : new_panels)
+				panel->setProperty("no_ini", "true");
+		}
 	}
 
 	//add new child group to column number "panel_number", effectively sorting the children:
 	container_->getGridLayout()->addWidget(new_group, panel_number, 0);
+	if (recycled)
+		new_group->setVisible(true);
+}
+
+/**
+ * @brief Show the child container after items have been added.
+ */
+void Replicator::showItems()
+{
 	container_->setVisible(true);
 	this->setProperty("is_mandatory", "false"); //if it's mandatory then the template now shows this
 	setPanelStyle(MANDATORY, false);
-	setBufferedUpdatesEnabled(1);
 }
 
 /**
@@ -152,8 +203,7 @@ bool Replicator::deleteLast()
 	auto *to_delete( qobject_cast<Group *>(container_->getGridLayout()->
 	    itemAtPosition(last_row, 0)->widget()) );
 	if (to_delete) {
-		to_delete->erase(); //delete the group's children
-		delete to_delete; //delete the group itself
+		item_template_.recycleItem(QString::number(last_row), to_delete); //keep for reuse
 #ifdef DEBUG
 	} else {
 		qDebug() << "Could not find a grid layout item to erase when it should have existed in Replicator::deleteLast()";
@@ -182,7 +232,7 @@ bool Replicator::deleteLast()
  */
 void Replicator::onPropertySet()
 { //gets called alphabetically (but it's 1, 10, 2, ...)
-	const QString panel_to_add( this->property("ini_value").toString() );
+	const QString panel_to_add( getRequestedValue() );
 	if (panel_to_add.isNull()) //when cleared
 		return;
 	replicate(panel_to_add.toInt());
@@ -190,10 +240,30 @@ void Replicator::onPropertySet()
 
 /**
  * @brief This function removes all child panels.
+ * @details All items are collected in a single pass over the grid and recycled, instead of
+ * searching for the last one again for every item.
  * @param[in] set_default Unused in this panel.
  */
 void Replicator::clear(const bool &/*set_default*/)
 {
-	while (deleteLast());
-	this->setProperty("ini_value", QString()); //so that new requests will trigger
+	if (container_->count() > 0) {
+		setUpdatesEnabled(false);
+		QList<QPair<int, Group *>> items; //row (= item number) and item
+		QGridLayout *grid( container_->getGridLayout() );
+		for (int ii = 0; ii < grid->count(); ++ii) {
+			int row, col, rowspan, colspan;
+			grid->getItemPosition(ii, &row, &col, &rowspan, &colspan);
+			if (auto *item = qobject_cast<Group *>(grid->itemAt(ii)->widget()))
+				items.push_back(qMakePair(row, item));
+		}
+		for (auto &item : items) //recycling changes the layout, so not in the loop above
+			item_template_.recycleItem(QString::number(item.first), item.second);
+		if (templ_.toElement().attribute("optional") == "false") { //cf. deleteLast()
+			this->setProperty("is_mandatory", "true");
+			setPanelStyle(MANDATORY);
+		}
+		container_->setVisible(false);
+		setBufferedUpdatesEnabled();
+	}
+	setValue(QString()); //so that new requests will trigger
 }
@@ -28,7 +28,9 @@
 
 #include "Atomic.h"
 #include "Group.h"
+#include "ItemTemplate.h"
 
+#include <QList>
 #include <QPushButton>
 #include <QString>
 #include <QWidget>
@@ -42,12 +44,16 @@ class Replicator : public Atomic {
 		    const bool &no_spacers, QWidget *parent = nullptr);
 		int count() const { return container_->count(); }
 		void clear(const bool &set_default = true) override;
+		void replicateAll(QList<int> panel_numbers);
 
 	private:
 		void setOptions(const QDomNode &options);
 		int findLastItemRow() const;
+		void addItem(const int &panel_number);
+		void showItems();
 
 		QDomNode templ_;
+		ItemTemplate item_template_; //compiled template and recycled items
 		Group *container_ = nullptr;
 		QPushButton *plus_button_ = nullptr;
 
@@ -20,7 +20,6 @@
 #include "Label.h"
 #include "src/main/constants.h"
 #include "src/main/inishell.h"
-#include "src/main/XMLReader.h"
 
 #include <QPushButton>
 
@@ -129,10 +128,10 @@ Selector::~Selector()
 void Selector::clear(const bool &/*set_default*/)
 {
 	for (auto &gr : container_map_)
-		delete gr.second;
+		item_template_.recycleItem(gr.first, gr.second); //keep for reuse
 	container_map_.clear();
 	container_->setVisible(false);
-	this->setProperty("ini_value", QString()); //so that new requests will trigger
+	setValue(QString()); //so that new requests will trigger
 }
 
 /**
@@ -150,7 +149,8 @@ void Selector::setOptions(const QDomNode &options)
 				break;
 			}
 			templ_ = par; //save the node describing the child (shallow copy)
-			this->setObjectName(getQtKey(section_ + Cst::sep + par.attribute("key")));
+			item_template_.compile(templ_, "%", "template"); //draw instances (don't use as template again)
+			registerKey(section_ + Cst::sep + par.attribute("key"), true);
 			found_template = true;
 		}
 	}
@@ -188,24 +188,24 @@ void Selector::guiAddPanel()
 
 /**
  * @brief Construct a new child panel from the template.
- * @details This function gives the Dropdown text to the template and constructs a new clone
- * of the template panel.
+ * @details This function gives the Dropdown text to the compiled template and constructs a new
+ * instance of the template panel. If a panel existed for this text before it is reused instead.
  * @param[in] param_text The text to transport to the child panel.
  */
 void Selector::addPanel(const QString &param_text)
 {
-	//we clone the child node (deep copy for string replacement) and put it in a dummy parent:
-	QDomNode node( prependParent(templ_) ); //nest for recursion
-	QDomElement element( node.toElement() );
-	substituteKeys(element, "%", param_text); //recursive substitution for all children
-	//draw it on next call (don't use as template again):
-	node.firstChildElement("parameter").setAttribute("template", "false");
-
-	/* construct all children and grandchildren */
-	Group *new_group( new Group(section_, "_selector_panel_" + key_) );
-	recursiveBuild(node, new_group, section_);
+	Group *new_group( item_template_.takeItem(param_text) );
+	const bool recycled = (new_group != nullptr);
+	if (!recycled) {
+		const QDomNode node( item_template_.instantiate(param_text) ); //substitution for all children
+		/* construct all children and grandchildren */
+		new_group = new Group(section_, "_selector_panel_" + key_);
+		recursiveBuild(node, new_group, section_);
+	}
 	container_->addWidget(new_group);
 	container_->setVisible(true);
+	if (recycled)
+		new_group->setVisible(true);
 	this->setProperty("is_mandatory", "false"); //if it's mandatory then the template now shows this
 	setPanelStyle(MANDATORY, false);
 
@@ -222,8 +222,7 @@ void Selector::removePanel(const QString &param_text)
 	auto it( container_map_.find(param_text) ); //look up if item exists in map
 	if (it != container_map_.end()) {
 		topStatus(""); //no "does not exist" error message from earlier
-		it->second->erase(); //delete the group's children
-		delete it->second; //delete the group itself
+		item_template_.recycleItem(it->first, it->second); //keep for reuse
 		container_map_.erase(it);
 		if (container_map_.empty()) { //no more children - save a couple of blank pixels
 			container_->setVisible(false);
@@ -258,7 +257,7 @@ void Selector::removeCurrentPanel()
  */
 void Selector::onPropertySet()
 {
-	const QString panel_to_add( this->property("ini_value").toString() );
+	const QString panel_to_add( getRequestedValue() );
 	if (panel_to_add.isNull()) //when cleared
 		return;
 	addPanel(panel_to_add);
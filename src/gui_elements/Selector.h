@@ -28,6 +28,7 @@
 
 #include "Atomic.h"
 #include "Group.h"
+#include "ItemTemplate.h"
 #include "src/main/common.h"
 
 #include <QComboBox>
@@ -65,6 +66,7 @@ class Selector : public Atomic {
 		inline QString getCurrentText() const { return textfield_? textfield_->text() : dropdown_->currentText(); }
 
 		QDomNode templ_;
+		ItemTemplate item_template_; //compiled template and recycled items
 		std::map<QString, Group *, CaseInsensitiveCompare> container_map_;
 		QComboBox *dropdown_ = nullptr;
 		QLineEdit *textfield_ = nullptr;
@@ -18,10 +18,13 @@
 
 #include "Textfield.h"
 #include "Label.h"
+#include "ValidationScheduler.h"
 #include "src/main/expressions.h"
+#include "src/main/inishell.h"
 
 #include <QDesktopServices>
 #include <QHBoxLayout>
+#include <QPointer>
 #include <QToolButton>
 
 #ifdef DEBUG
@@ -57,6 +60,10 @@ Textfield::Textfield(const QString &section, const QString &key, const QDomNode
 	auto *field_button_layout( new QHBoxLayout );
 	field_button_layout->addWidget(textfield_);
 	field_button_layout->addWidget(check_button_);
+	evaluation_label_ = new QLabel;
+	evaluation_label_->setToolTip(tr("Current value of the expression"));
+	evaluation_label_->hide();
+	field_button_layout->addWidget(evaluation_label_);
 	auto *textfield_layout( new QHBoxLayout );
 	setLayoutMargins(textfield_layout);
 	textfield_layout->addWidget(key_label, 0, Qt::AlignLeft);
@@ -76,13 +83,29 @@ Textfield::Textfield(const QString &section, const QString &key, const QDomNode
 	setOptions(options);
 }
 
+/**
+ * @brief Destructor which removes the panel's expression from the dependency graph.
+ */
+Textfield::~Textfield()
+{
+	expr::ExpressionGraph::getShared().removeDependent(this); //its callback refers to this panel
+}
+
 /**
  * @brief Parse options for a Textfield from XML.
  * @param[in] options XML node holding the Textfield.
  */
 void Textfield::setOptions(const QDomNode &options)
 {
-	validation_regex_ = options.toElement().attribute("validate");
+	const QString validation_regex( options.toElement().attribute("validate") );
+	if (!validation_regex.isNull()) {
+		validation_rex_.setPattern(validation_regex);
+		validation_rex_.optimize(); //JIT compile once instead of on every keystroke
+		has_validation_ = true;
+		if (!validation_rex_.isValid())
+			topLog(tr(R"(XML error: Invalid validation regex for Textfield "%1::%2": %3)").arg(
+			    section_, key_, validation_rex_.errorString()), "error");
+	}
 	if (options.toElement().attribute("lenient").toLower() == "true")
 		needs_prefix_for_evaluation_ = false; //always evaluate arithmetic expressions
 	if (!options.toElement().attribute("placeholder").isEmpty())
@@ -94,48 +117,122 @@ void Textfield::setOptions(const QDomNode &options)
 
 /**
  * @brief Event listener for changed INI values.
- * @details The "ini_value" property is set when parsing default values and potentially again
+ * @details The panel's value is set via setValue() when parsing default values and potentially again
  * when setting INI keys while parsing a file.
  */
 void Textfield::onPropertySet()
 {
-	const QString text_to_set( this->property("ini_value").toString() );
+	const QString text_to_set( getRequestedValue() );
 	if (ini_value_ == text_to_set)
 		return;
 	textfield_->setText(text_to_set);
-	checkValue(text_to_set);
+	setIniValue(text_to_set);
+	scheduleCheck(text_to_set, 0); //checked together with all other panels being set right now
 }
 
 /**
- * @brief Perform checks on the entered text.
- * @details This function checks if the entered text stands for a recognized format such
- * as expressions (like the Number panel does), and if yes, styles the text box.
+ * @brief Event listener for entered text.
+ * @details The value is set right away, the checks are run when the user stops typing.
  * @param[in] text The current text to check.
  */
 void Textfield::checkValue(const QString &text)
+{
+	setIniValue(text); //checks are just a hint - set anyway
+	scheduleCheck(text, Cst::validation_delay);
+}
+
+/**
+ * @brief Request checking a text with the validation scheduler.
+ * @details The check is run on a worker thread on copies of the panel's settings, and the result
+ * is applied to the panel if it still exists.
+ * @param[in] text The text to check.
+ * @param[in] delay Time in ms to wait for further input.
+ */
+void Textfield::scheduleCheck(const QString &text, const int &delay)
+{
+	const QPointer<Textfield> panel( this );
+	const QRegularExpression validation_rex( validation_rex_ );
+	const bool has_validation = has_validation_;
+	const std::vector<std::pair<QString, QString>> substitutions( substitutions_ );
+	const bool needs_prefix = needs_prefix_for_evaluation_;
+	ValidationScheduler::getShared().schedule(this, [=]() -> ValidationScheduler::ApplyFunction {
+		const TextfieldCheck check( checkText(text, validation_rex, has_validation, substitutions, needs_prefix) );
+		return [=]() {
+			if (!panel.isNull())
+				panel->applyCheck(text, check);
+		};
+	}, delay);
+}
+
+/**
+ * @brief Perform checks on a text (runs on a worker thread).
+ * @details This function checks if the entered text stands for a recognized format such
+ * as expressions (like the Number panel does), or matches the regex given in the XML.
+ * @param[in] text The text to check.
+ * @param[in] validation_rex The regex given in the XML.
+ * @param[in] has_validation True if the XML specifies a regex.
+ * @param[in] substitutions User-set substitutions for expressions.
+ * @param[in] needs_prefix Evaluate arithmetic expressions only with ${{...}}.
+ * @return The result of the checks.
+ */
+TextfieldCheck Textfield::checkText(const QString &text, const QRegularExpression &validation_rex,
+    const bool &has_validation, const std::vector<std::pair<QString, QString>> &substitutions,
+    const bool &needs_prefix)
 {
 	/* check for coordinates */
 	static const QString regex_coord(R"(\Alatlon\s*\(([-\d\.]+)(?:,)\s*([-\d\.]+)((?:,)\s*([-\d\.]+))?\))");
 	static const QRegularExpression rex_coord(regex_coord);
 	const QRegularExpressionMatch coord_match(rex_coord.match(text));
-
 	static const int idx_full = 0;
-	setDefaultPanelStyles(text);
+
+	TextfieldCheck check;
 	if (coord_match.captured(idx_full) == text && !text.isEmpty()) {
-		check_button_->setVisible(true);
-	} else {
-		check_button_->setVisible(false);
-		if (!validation_regex_.isNull()) { //check against regex specified in XML
-			const QRegularExpression rex_xml(validation_regex_);
-			const QRegularExpressionMatch xml_match(rex_xml.match(text));
-			setValidPanelStyle(xml_match.captured(idx_full) == text && !text.isEmpty());
-		} else { //check for (arithmetic) expressions
-			bool evaluation_success;
-			if (expr::checkExpression(text, evaluation_success, substitutions_, needs_prefix_for_evaluation_))
-				setValidPanelStyle(evaluation_success);
-		}
+		check.is_coordinate = true;
+	} else if (has_validation) { //check against regex specified in XML
+		const QRegularExpressionMatch xml_match(validation_rex.match(text));
+		check.is_checked = true;
+		check.is_valid = (xml_match.captured(idx_full) == text && !text.isEmpty());
+	} else { //check for (arithmetic) expressions
+		const expr::ExpressionCheck expression( expr::parseExpression(text, substitutions, needs_prefix) );
+		check.is_checked = expression.is_expression;
+		check.is_valid = expression.evaluation_success;
+		check.ini_keys = expression.ini_keys;
 	}
-	setIniValue(text); //checks are just a hint - set anyway
+	return check;
+}
+
+/**
+ * @brief Style the text box according to the result of a check.
+ * @details Valid expressions are evaluated and their value is shown next to the text box.
+ * @param[in] text The text that was checked.
+ * @param[in] check The result of the check.
+ */
+void Textfield::applyCheck(const QString &text, const TextfieldCheck &check)
+{
+	if (textfield_->text() != text) //outdated - a check for the new text is on its way
+		return;
+	setDefaultPanelStyles(text);
+	check_button_->setVisible(check.is_coordinate);
+	expr::ExpressionCheck expression;
+	expression.evaluation_success = check.is_valid;
+	expression.ini_keys = check.ini_keys;
+	if (check.is_checked)
+		expr::resolveExpression(expression);
+
+	QString value;
+	QStringList evaluated_keys; //also the keys referenced by referenced expressions
+	const bool has_value = check.is_checked && !has_validation_ && expression.evaluation_success &&
+	    expr::previewValue(text, section_ + Cst::sep + key_, value, evaluated_keys, needs_prefix_for_evaluation_);
+	evaluation_label_->setText(has_value? "= " + value : QString());
+	evaluation_label_->setVisible(has_value);
+	evaluated_keys.append(check.ini_keys);
+	evaluated_keys.removeDuplicates();
+	//INI keys can only be looked up here, and the check is repeated when they change:
+	expr::ExpressionGraph::getShared().setDependencies(this, evaluated_keys, [this]() {
+		scheduleCheck(textfield_->text(), 0);
+	});
+	if (check.is_checked)
+		setValidPanelStyle(expression.evaluation_success);
 }
 
 /**
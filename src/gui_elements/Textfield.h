@@ -26,28 +26,54 @@
 
 #include "Atomic.h"
 
+#include <QLabel>
 #include <QLineEdit>
+#include <QRegularExpression>
 #include <QString>
+#include <QStringList>
 #include <QWidget>
 #include <QtXml>
 
 #include <utility>
 #include <vector>
 
+/**
+ * @struct TextfieldCheck
+ * @brief Result of checking a Textfield's text (computed on a worker thread).
+ */
+struct TextfieldCheck {
+	bool is_coordinate = false; //text is a coordinate that can be shown on a map
+	bool is_checked = false; //text was checked against the XML regex or as an expression
+	bool is_valid = false;
+	QStringList ini_keys; //expression refers to INI keys that have to be looked up on the GUI thread
+};
+
 class Textfield : public Atomic {
 	Q_OBJECT
 
 	public:
 		explicit Textfield(const QString &section, const QString &key, const QDomNode &options,
 		    const bool &no_spacers, QWidget *parent = nullptr);
+		~Textfield() override;
+		Textfield(const Textfield&) = delete;
+		Textfield& operator =(Textfield const&) = delete;
+		Textfield(Textfield&&) = delete;
+		Textfield& operator=(Textfield&&) = delete;
 
 	private:
 		void setOptions(const QDomNode &options);
+		void scheduleCheck(const QString &text, const int &delay);
+		void applyCheck(const QString &text, const TextfieldCheck &check);
+		static TextfieldCheck checkText(const QString &text, const QRegularExpression &validation_rex,
+		    const bool &has_validation, const std::vector<std::pair<QString, QString>> &substitutions,
+		    const bool &needs_prefix);
 
 		std::vector<std::pair<QString, QString>> substitutions_; //user-set substitutions to translate to tinyexpr
-		QString validation_regex_;
+		QRegularExpression validation_rex_; //compiled once from the XML
+		bool has_validation_ = false;
 		QLineEdit *textfield_ = nullptr;
 		QToolButton *check_button_ = nullptr;
+		QLabel *evaluation_label_ = nullptr; //shows the value of an expression
 		bool needs_prefix_for_evaluation_ = true;
 
 	private slots:
@@ -0,0 +1,122 @@
+/*****************************************************************************/
+/*  Copyright 2019 WSL Institute for Snow and Avalanche Research  SLF-DAVOS  */
+/*****************************************************************************/
+/* This file is part of INIshell.
+   INIshell is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   INIshell is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with INIshell.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "ValidationScheduler.h"
+
+#include <QCoreApplication>
+#include <QtConcurrent/QtConcurrentRun>
+
+/**
+ * @class ValidationScheduler
+ * @brief Get the scheduler that all panels send their checks to.
+ * @return The shared scheduler (created on first use).
+ */
+ValidationScheduler & ValidationScheduler::getShared()
+{
+	static ValidationScheduler *scheduler( new ValidationScheduler(qApp) ); //deleted with the application
+	return *scheduler;
+}
+
+/**
+ * @brief Constructor for the validation scheduler.
+ * @param[in] parent The parent object.
+ */
+ValidationScheduler::ValidationScheduler(QObject *parent) : QObject(parent)
+{
+	debounce_timer_.setSingleShot(true);
+	connect(&debounce_timer_, &QTimer::timeout, this, &ValidationScheduler::startChecks);
+	connect(&check_watcher_, &QFutureWatcher<std::vector<ApplyFunction>>::finished, this,
+	    &ValidationScheduler::onChecksFinished);
+}
+
+/**
+ * @brief Request a check.
+ * @details A check replaces a pending check of the same owner, so while the user is typing only
+ * the last text is checked. The timer is restarted with each request, i. e. checks start when the
+ * typing pauses, also while a batch of checks is running. With a delay of 0 (e. g. when loading an
+ * INI file) all checks requested in the same event loop turn are run together.
+ * @param[in] owner The object the check is for (usually a panel). If it is deleted before the
+ * check runs, the check is dropped.
+ * @param[in] check Function doing the check on a worker thread. It returns the function that
+ * applies the result on the GUI thread.
+ * @param[in] delay Time in ms to wait for further requests.
+ */
+void ValidationScheduler::schedule(QObject *owner, CheckFunction check, const int &delay)
+{
+	pending_.insert(owner, std::make_pair(QPointer<QObject>(owner), std::move(check)));
+	//typing restarts the timer, immediate checks don't wait for it:
+	if (delay > 0 || !debounce_timer_.isActive() || debounce_timer_.remainingTime() > 0)
+		debounce_timer_.start(delay);
+}
+
+/**
+ * @brief Run all pending checks on a worker thread.
+ * @details If a batch is still running, the checks are started as soon as it is done.
+ */
+void ValidationScheduler::startChecks()
+{
+	if (check_watcher_.isRunning()) {
+		start_when_finished_ = true;
+		return;
+	}
+	if (pending_.isEmpty())
+		return;
+	std::vector<CheckFunction> checks;
+	checks.reserve(static_cast<size_t>(pending_.size()));
+	for (auto &check : pending_) {
+		if (!check.first.isNull()) //owner still exists
+			checks.push_back(std::move(check.second));
+	}
+	pending_.clear();
+	check_watcher_.setFuture(QtConcurrent::run(&ValidationScheduler::runChecks, checks));
+}
+
+/**
+ * @brief Run a batch of checks (on a worker thread).
+ * @param[in] checks The checks to run.
+ * @return The functions to apply the results with.
+ */
+std::vector<ValidationScheduler::ApplyFunction> ValidationScheduler::runChecks(
+    const std::vector<CheckFunction> &checks)
+{
+	std::vector<ApplyFunction> results;
+	results.reserve(checks.size());
+	for (auto &check : checks)
+		results.push_back(check());
+	return results;
+}
+
+/**
+ * @brief Apply the results of finished checks on the GUI thread.
+ * @details Checks whose debounce time has run out while the batch was running are started now
+ * (only one batch runs at a time so that results can not arrive out of order). Others are still
+ * waiting for the debounce timer.
+ */
+void ValidationScheduler::onChecksFinished()
+{
+	const std::vector<ApplyFunction> results( check_watcher_.result() );
+	for (auto &apply : results) {
+		if (apply)
+			apply();
+	}
+	if (start_when_finished_) {
+		start_when_finished_ = false;
+		startChecks();
+	}
+}
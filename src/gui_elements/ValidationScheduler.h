@@ -0,0 +1,67 @@
+/*****************************************************************************/
+/*  Copyright 2019 WSL Institute for Snow and Avalanche Research  SLF-DAVOS  */
+/*****************************************************************************/
+/* This file is part of INIshell.
+   INIshell is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   INIshell is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with INIshell.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*
+ * Central scheduler for the syntax checks of panels. Checks requested while the user is typing
+ * are debounced, all pending checks are run together on a worker thread, and the results are
+ * applied on the GUI thread.
+ * 2020-05
+ */
+
+#ifndef VALIDATIONSCHEDULER_H
+#define VALIDATIONSCHEDULER_H
+
+#include "src/main/constants.h"
+
+#include <QFutureWatcher>
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+class ValidationScheduler : public QObject {
+	Q_OBJECT
+
+	public:
+		using ApplyFunction = std::function<void()>; //runs on the GUI thread
+		using CheckFunction = std::function<ApplyFunction()>; //runs on a worker thread, must be thread safe
+
+		static ValidationScheduler & getShared();
+		void schedule(QObject *owner, CheckFunction check, const int &delay = Cst::validation_delay);
+		void cancel(QObject *owner) { pending_.remove(owner); }
+
+	private:
+		explicit ValidationScheduler(QObject *parent = nullptr);
+		void startChecks();
+		static std::vector<ApplyFunction> runChecks(const std::vector<CheckFunction> &checks);
+
+		QHash<QObject *, std::pair<QPointer<QObject>, CheckFunction>> pending_; //newest check per owner
+		QTimer debounce_timer_;
+		bool start_when_finished_ = false; //the timer ran out while a batch was running
+		QFutureWatcher<std::vector<ApplyFunction>> check_watcher_;
+
+	private slots:
+		void onChecksFinished();
+};
+
+#endif //VALIDATIONSCHEDULER_H
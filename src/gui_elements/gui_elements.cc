@@ -98,7 +98,8 @@ QWidget * elementFactory(const QString &in_identifier, const QString &section, c
 		}
 		if (!default_value.isNull()) {
 			element->setProperty("default_value", default_value); //should call setDefaultPanelStyles()
-			element->setProperty("ini_value", default_value);
+			if (auto *atomic_element = qobject_cast<Atomic *>(element))
+				atomic_element->setValue(default_value);
 		} else if (is_mandatory) {
 			auto *atomic_element = static_cast<Atomic *>(element);
 			atomic_element->setDefaultPanelStyles(QString());
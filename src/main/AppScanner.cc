@@ -0,0 +1,430 @@
+/*****************************************************************************/
+/*  Copyright 2019 WSL Institute for Snow and Avalanche Research  SLF-DAVOS  */
+/*****************************************************************************/
+/* This file is part of INIshell.
+   INIshell is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   INIshell is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with INIshell.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "AppScanner.h"
+#include "src/main/constants.h"
+#include "src/main/settings.h"
+
+#include <QCoreApplication> //for translations
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegExp>
+#include <QRegularExpression>
+#include <QStandardPaths>
+#include <QTextStream>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtXml>
+
+/**
+ * @class AppScanner
+ * @brief Default constructor for the application scanner.
+ * @details The scanner reads the header cache of the last run and prepares the file system
+ * watcher which triggers incremental scans of single directories.
+ * @param[in] parent The parent object.
+ */
+AppScanner::AppScanner(QObject *parent) : QObject(parent)
+{
+	loadCache();
+	connect(&scan_watcher_, &QFutureWatcher<AppScanResult>::resultReadyAt, this, &AppScanner::onResultReady);
+	connect(&scan_watcher_, &QFutureWatcher<AppScanResult>::finished, this, &AppScanner::onScanFinished);
+	connect(&fs_watcher_, &QFileSystemWatcher::directoryChanged, this, &AppScanner::onDirectoryChanged);
+	change_timer_.setSingleShot(true);
+	change_timer_.setInterval(Cst::app_scan_delay);
+	connect(&change_timer_, &QTimer::timeout, this, &AppScanner::onChangeTimer);
+}
+
+/**
+ * @brief Destructor which waits for a running scan to finish.
+ */
+AppScanner::~AppScanner()
+{
+	scan_watcher_.waitForFinished();
+}
+
+/**
+ * @brief Scan all given directories for application and simulation XML files.
+ * @details The scan is performed on worker threads (one per search directory). Results are
+ * streamed via directoriesFound() and scanFinished() is emitted when it's done.
+ * Depending on the settings, subdirectories are searched as well. All directories that are
+ * found are watched for changes.
+ * @param[in] directories The list of directories to search.
+ */
+void AppScanner::scan(const QStringList &directories)
+{
+	search_dirs_ = directories;
+	search_depth_ = qMax(0, getIntSetting("user::appsearch::depth"));
+	ignore_patterns_ = getSetting("user::appsearch::ignore", "value").split(
+	    QRegExp("\\s+"), QString::SkipEmptyParts);
+	startScan(search_dirs_, true);
+}
+
+/**
+ * @brief Start a background scan or queue it if one is already running.
+ * @param[in] directories The directories to scan.
+ * @param[in] full_scan True if this is a scan of all search directories.
+ */
+void AppScanner::startScan(const QStringList &directories, const bool &full_scan)
+{
+	if (scan_watcher_.isRunning()) { //picked up when the current scan is done
+		if (full_scan) {
+			pending_full_scan_ = true;
+			pending_dirs_.clear();
+		} else if (!pending_full_scan_) {
+			for (auto &dir : directories) {
+				if (!pending_dirs_.contains(dir))
+					pending_dirs_ << dir;
+			}
+		}
+		return;
+	}
+
+	QList<AppScanTask> tasks;
+	const auto visited( std::make_shared<AppVisitedDirs>() ); //to skip folders reached via different paths
+	for (int ii = 0; ii < directories.size(); ++ii) {
+		AppScanTask task;
+		task.directory = directories.at(ii);
+		if (full_scan) {
+			task.root_index = ii;
+			task.depth = search_depth_;
+		} else { //rescan of a known directory
+			const auto known( known_dirs_.constFind(task.directory) );
+			if (known == known_dirs_.constEnd())
+				continue;
+			task.root_index = known->first;
+			task.depth = known->second;
+		}
+		task.ignore_patterns = ignore_patterns_;
+		task.cache = cache_;
+		task.visited = visited;
+		tasks << task;
+	}
+	if (tasks.isEmpty())
+		return;
+
+	current_scan_ = AppScanResult();
+	current_scan_.full_scan = full_scan;
+	scanned_roots_ = directories;
+	if (full_scan && !fs_watcher_.directories().isEmpty())
+		fs_watcher_.removePaths(fs_watcher_.directories());
+	scan_watcher_.setFuture(QtConcurrent::mapped(tasks, &AppScanner::walkDirectory));
+}
+
+/**
+ * @brief Search a directory tree for XML files (runs on a worker thread).
+ * @details The tree is walked breadth first down to the requested depth. Directories that
+ * have already been searched (e. g. through a symbolic link or from a different search
+ * directory) are skipped.
+ * @param[in] task The directory tree to walk.
+ * @return All XML files found in the directory tree.
+ */
+AppScanResult AppScanner::walkDirectory(const AppScanTask &task)
+{
+	AppScanResult result;
+	std::vector<std::pair<QString, int>> queue{ {task.directory, task.depth} };
+	for (size_t ii = 0; ii < queue.size(); ++ii) {
+		const QString directory( queue.at(ii).first );
+		const int depth = queue.at(ii).second;
+		const QFileInfo dinfo( directory );
+		if (dinfo.exists() && !task.visited->insert(dinfo.canonicalFilePath()))
+			continue;
+
+		AppDirectory app_dir( scanDirectory(directory, task.cache, result.errors) );
+		app_dir.root_index = task.root_index;
+		app_dir.depth = depth;
+		result.directories.push_back(app_dir);
+
+		if (depth <= 0 || !dinfo.isDir())
+			continue;
+		const QStringList subdirs( QDir(directory).entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name) );
+		for (auto &sub : subdirs) {
+			if (!QDir::match(task.ignore_patterns, sub))
+				queue.emplace_back(directory + "/" + sub, depth - 1);
+		}
+	}
+	return result;
+}
+
+/**
+ * @brief Look for XML files in a single directory.
+ * @details Files that are found in the cache with the same size and modification time
+ * are not opened again.
+ * @param[in] directory The directory to scan.
+ * @param[in] cache Copy of the header cache.
+ * @param[out] errors List of errors to add to.
+ * @return All XML files found in the directory.
+ */
+AppDirectory AppScanner::scanDirectory(const QString &directory, const QMap<QString, AppHeader> &cache,
+    QStringList &errors)
+{
+	static const QStringList filters = {"*.xml", "*.XML"};
+	AppDirectory app_dir;
+	app_dir.directory = directory;
+	if (directory.isEmpty())
+		return app_dir;
+
+	const QFileInfoList files( QDir(directory).entryInfoList(filters, QDir::Files) );
+	for (auto &finfo : files) {
+		AppHeader header;
+		header.file_name = directory + "/" + finfo.fileName();
+		header.directory = directory;
+		header.size = finfo.size();
+		header.mtime = finfo.lastModified().toMSecsSinceEpoch();
+		const auto cached( cache.constFind(header.file_name) );
+		if (cached != cache.constEnd() && cached->size == header.size && cached->mtime == header.mtime) {
+			header = *cached; //unchanged since the last scan
+			header.directory = directory;
+		} else {
+			QString error;
+			if (!readHeader(header, error)) {
+				errors << error;
+				continue; //don't cache unreadable files
+			}
+		}
+		app_dir.files.push_back(header);
+	}
+	return app_dir;
+}
+
+/**
+ * @brief Read the beginning of an XML file and check if it's an application or simulation.
+ * @param[in,out] header Header info to fill; the file name must be set.
+ * @param[out] error Error message if the file could not be read.
+ * @return False if the file could not be read.
+ */
+bool AppScanner::readHeader(AppHeader &header, QString &error)
+{
+	QFile infile(header.file_name);
+	if (!infile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+		error = QCoreApplication::translate("WorkflowPanel", R"(Could not check application file: unable to read "%1" (%2))").arg(
+		    QDir::toNativeSeparators(header.file_name), infile.errorString());
+		return false;
+	}
+	QTextStream tstream(&infile);
+	int linecount = 0;
+	while (!tstream.atEnd()) {
+		linecount++;
+		if (linecount > 50) //allow this many lines of comments, but then assume it's not our file
+			break;
+		const QString line( tstream.readLine() );
+		static const QRegularExpression regex_inishell(R"(^\<inishell_config (application|simulation)=\"(.*?)\".*?(icon=\"(.*)\")*>.*)");
+		const QRegularExpressionMatch match_inishell(regex_inishell.match(line)); //^ allow XML comment at the end
+		static const int idx_type = 1;
+		static const int idx_name = 2;
+		static const int idx_icon = 4;
+		if (match_inishell.captured(0) == line && !line.isEmpty()) {
+			/*
+			 * There is no logical difference between a file containing
+			 * an application and one containing a simulation. The attribute
+			 * is used solemnly for clarity and to keep two separate lists
+			 * for the two.
+			 */
+			header.type = match_inishell.captured(idx_type).toLower();
+			header.name = match_inishell.captured(idx_name);
+			header.icon = match_inishell.captured(idx_icon);
+			break;
+		}
+	} //endwhile
+	return true;
+}
+
+/**
+ * @brief Event listener for results of a directory tree that are ready.
+ * @details Results are handed on right away so that the lists can be populated while other
+ * directories are still being searched.
+ * @param[in] index Index of the ready result.
+ */
+void AppScanner::onResultReady(int index)
+{
+	const AppScanResult result( scan_watcher_.resultAt(index) );
+	QStringList new_watches;
+	for (auto &app_dir : result.directories) {
+		current_scan_.directories.push_back(app_dir);
+		if (QFileInfo( app_dir.directory ).isDir() && !fs_watcher_.directories().contains(app_dir.directory))
+			new_watches << app_dir.directory;
+	}
+	current_scan_.errors.append(result.errors);
+	if (!new_watches.isEmpty())
+		fs_watcher_.addPaths(new_watches);
+	emit directoriesFound(result);
+}
+
+/**
+ * @brief Event listener for a finished background scan.
+ * @details Directories that are no longer found are reported, the cache is updated and saved,
+ * and queued scans are started.
+ */
+void AppScanner::onScanFinished()
+{
+	QSet<QString> found_dirs;
+	for (auto &app_dir : current_scan_.directories)
+		found_dirs.insert(app_dir.directory);
+	for (auto it = known_dirs_.begin(); it != known_dirs_.end();) {
+		bool was_scanned = current_scan_.full_scan;
+		for (auto &root : scanned_roots_) { //was in one of the rescanned directory trees?
+			if (it.key() == root || it.key().startsWith(root + "/")) {
+				was_scanned = true;
+				break;
+			}
+		}
+		if (was_scanned && !found_dirs.contains(it.key())) {
+			current_scan_.removed_directories << it.key();
+			it = known_dirs_.erase(it);
+		} else {
+			++it;
+		}
+	}
+	for (auto &app_dir : current_scan_.directories)
+		known_dirs_.insert(app_dir.directory, std::make_pair(app_dir.root_index, app_dir.depth));
+
+	mergeCache(current_scan_);
+	saveCache();
+	emit scanFinished(current_scan_);
+
+	if (pending_full_scan_) {
+		pending_full_scan_ = false;
+		startScan(search_dirs_, true);
+	} else if (!pending_dirs_.isEmpty()) {
+		const QStringList dirs( pending_dirs_ );
+		pending_dirs_.clear();
+		startScan(dirs, false);
+	}
+}
+
+/**
+ * @brief Update the header cache with the results of a scan.
+ * @details Entries of the scanned directories are replaced, i. e. files that have been
+ * removed are dropped from the cache.
+ * @param[in] result The scan result.
+ */
+void AppScanner::mergeCache(const AppScanResult &result)
+{
+	if (result.full_scan) {
+		cache_.clear();
+	} else {
+		QSet<QString> scanned_dirs;
+		for (auto &app_dir : result.directories)
+			scanned_dirs.insert(app_dir.directory);
+		for (auto &dir : result.removed_directories)
+			scanned_dirs.insert(dir);
+		for (auto it = cache_.begin(); it != cache_.end();) {
+			if (scanned_dirs.contains(it->directory))
+				it = cache_.erase(it);
+			else
+				++it;
+		}
+	}
+	for (auto &app_dir : result.directories) {
+		for (auto &header : app_dir.files)
+			cache_.insert(header.file_name, header);
+	}
+}
+
+/**
+ * @brief Event listener for changes in a watched directory.
+ * @details Editors often write files in several steps, so we wait a little before rescanning.
+ * @param[in] path The directory that has changed.
+ */
+void AppScanner::onDirectoryChanged(const QString &path)
+{
+	if (!changed_dirs_.contains(path))
+		changed_dirs_ << path;
+	change_timer_.start();
+}
+
+/**
+ * @brief Rescan the directories that have changed.
+ */
+void AppScanner::onChangeTimer()
+{
+	QStringList dirs;
+	for (auto &dir : changed_dirs_) {
+		if (known_dirs_.contains(dir))
+			dirs << dir;
+	}
+	changed_dirs_.clear();
+	if (!dirs.isEmpty())
+		startScan(dirs, false);
+}
+
+/**
+ * @brief Get the file name of the header cache.
+ * @return Path to the cache file in the system's cache location.
+ */
+QString AppScanner::getCacheFileName() const
+{
+	return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/" + Cst::app_cache_file_name;
+}
+
+/**
+ * @brief Read the header cache of the last run.
+ */
+void AppScanner::loadCache()
+{
+	QFile infile( getCacheFileName() );
+	if (!infile.open(QIODevice::ReadOnly))
+		return; //first run
+	QDomDocument cache_xml;
+	if (!cache_xml.setContent(&infile, false))
+		return; //broken cache - will be rewritten
+	for (QDomElement el = cache_xml.firstChildElement().firstChildElement("file"); !el.isNull();
+	    el = el.nextSiblingElement("file")) {
+		AppHeader header;
+		header.file_name = el.attribute("path");
+		header.directory = el.attribute("directory");
+		header.size = el.attribute("size").toLongLong();
+		header.mtime = el.attribute("mtime").toLongLong();
+		header.type = el.attribute("type");
+		header.name = el.attribute("name");
+		header.icon = el.attribute("icon");
+		cache_.insert(header.file_name, header);
+	}
+}
+
+/**
+ * @brief Write the header cache to the file system.
+ */
+void AppScanner::saveCache() const
+{
+	QDomDocument cache_xml;
+	QDomElement root( cache_xml.createElement("inishell_app_cache") );
+	cache_xml.appendChild(root);
+	for (auto &header : cache_) {
+		QDomElement el( cache_xml.createElement("file") );
+		el.setAttribute("path", header.file_name);
+		el.setAttribute("directory", header.directory);
+		el.setAttribute("size", QString::number(header.size));
+		el.setAttribute("mtime", QString::number(header.mtime));
+		if (!header.type.isEmpty()) { //non-INIshell XMLs only need the file stats
+			el.setAttribute("type", header.type);
+			el.setAttribute("name", header.name);
+			el.setAttribute("icon", header.icon);
+		}
+		root.appendChild(el);
+	}
+
+	const QString cache_file( getCacheFileName() );
+	QDir().mkpath(QFileInfo( cache_file ).absolutePath());
+	QFile outfile( cache_file );
+	if (!outfile.open(QIODevice::WriteOnly))
+		return; //not critical, we'll just scan again next time
+	QTextStream out_ss(&outfile);
+	out_ss << cache_xml.toString();
+	outfile.close();
+}
@@ -0,0 +1,161 @@
+/*****************************************************************************/
+/*  Copyright 2019 WSL Institute for Snow and Avalanche Research  SLF-DAVOS  */
+/*****************************************************************************/
+/* This file is part of INIshell.
+   INIshell is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   INIshell is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with INIshell.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Background search for application and simulation XML files in the search directories.
+ * File headers are cached between runs and the directories are watched for changes.
+ * Subdirectories can be searched up to a depth that is set in the settings.
+ * 2020-05
+ */
+
+#ifndef APPSCANNER_H
+#define APPSCANNER_H
+
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct AppHeader
+ * @brief Info extracted from the header line of an XML file.
+ * @details Files that are not INIshell XMLs are cached too (with an empty type) so that
+ * they are not opened again as long as they don't change.
+ */
+struct AppHeader {
+	QString file_name; //full path
+	QString directory; //search directory the file was found in
+	qint64 size = -1;
+	qint64 mtime = -1; //ms since epoch
+	QString type; //"application", "simulation", or empty if not an INIshell file
+	QString name;
+	QString icon;
+};
+
+/**
+ * @struct AppDirectory
+ * @brief All XML files found in a single directory.
+ */
+struct AppDirectory {
+	QString directory;
+	int root_index = -1; //position of the search directory this one was found in
+	int depth = 0; //remaining levels of subdirectories to descend into
+	std::vector<AppHeader> files;
+};
+
+/**
+ * @struct AppScanResult
+ * @brief Output of a background scan (or a part of it).
+ */
+struct AppScanResult {
+	std::vector<AppDirectory> directories;
+	QStringList removed_directories; //directories that were found previously but are gone now
+	QStringList errors; //to be logged on the GUI thread
+	bool full_scan = false; //all search directories were scanned
+};
+
+/**
+ * @struct AppVisitedDirs
+ * @brief Canonical paths of directories that have been searched, shared between worker threads.
+ */
+struct AppVisitedDirs {
+	bool insert(const QString &canonical_path) {
+		QMutexLocker lock(&mutex);
+		if (dirs.contains(canonical_path))
+			return false;
+		dirs.insert(canonical_path);
+		return true;
+	}
+
+	QMutex mutex;
+	QSet<QString> dirs;
+};
+
+/**
+ * @struct AppScanTask
+ * @brief Description of a directory tree to walk on a worker thread.
+ */
+struct AppScanTask {
+	QString directory;
+	int root_index = 0;
+	int depth = 0; //how many levels of subdirectories to descend into
+	QStringList ignore_patterns; //wildcards for subdirectories to skip
+	QMap<QString, AppHeader> cache; //implicitly shared copy of the header cache
+	std::shared_ptr<AppVisitedDirs> visited;
+};
+
+class AppScanner : public QObject {
+	Q_OBJECT
+
+	public:
+		explicit AppScanner(QObject *parent = nullptr);
+		~AppScanner() override;
+		AppScanner(const AppScanner&) = delete;
+		AppScanner& operator =(AppScanner const&) = delete;
+		AppScanner(AppScanner&&) = delete;
+		AppScanner& operator=(AppScanner&&) = delete;
+		void scan(const QStringList &directories);
+		bool isScanning() const { return scan_watcher_.isRunning(); }
+
+	signals:
+		void directoriesFound(const AppScanResult &result); //streamed while scanning
+		void scanFinished(const AppScanResult &result);
+
+	private:
+		void startScan(const QStringList &directories, const bool &full_scan);
+		static AppScanResult walkDirectory(const AppScanTask &task);
+		static AppDirectory scanDirectory(const QString &directory, const QMap<QString, AppHeader> &cache,
+		    QStringList &errors);
+		static bool readHeader(AppHeader &header, QString &error);
+		void mergeCache(const AppScanResult &result);
+		void loadCache();
+		void saveCache() const;
+		QString getCacheFileName() const;
+
+		QStringList search_dirs_; //current list of directories to scan
+		int search_depth_ = 0; //levels of subdirectories to search
+		QStringList ignore_patterns_;
+		QHash<QString, std::pair<int, int>> known_dirs_; //directory -> (root index, remaining depth)
+		QStringList pending_dirs_; //directories waiting for the running scan to finish
+		bool pending_full_scan_ = false;
+		QStringList scanned_roots_; //directory trees of the running scan
+		AppScanResult current_scan_; //collects the streamed results of the running scan
+		QMap<QString, AppHeader> cache_; //file name -> header
+		QFutureWatcher<AppScanResult> scan_watcher_;
+		QFileSystemWatcher fs_watcher_;
+		QTimer change_timer_; //collect bursts of file system events
+		QStringList changed_dirs_;
+
+	private slots:
+		void onResultReady(int index);
+		void onScanFinished();
+		void onDirectoryChanged(const QString &path);
+		void onChangeTimer();
+};
+
+#endif //APPSCANNER_H
@@ -0,0 +1,264 @@
+/*****************************************************************************/
+/*  Copyright 2019 WSL Institute for Snow and Avalanche Research  SLF-DAVOS  */
+/*****************************************************************************/
+/* This file is part of INIshell.
+   INIshell is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   INIshell is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with INIshell.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "FileStatCache.h"
+
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QPointer>
+#include <QtConcurrent/QtConcurrentRun>
+
+/**
+ * @class FileStatCache
+ * @brief Get the cache that all panels share.
+ * @return The shared file stat cache (created on first use).
+ */
+FileStatCache & FileStatCache::getShared()
+{
+	static FileStatCache *cache( new FileStatCache(qApp) ); //deleted with the application
+	return *cache;
+}
+
+/**
+ * @brief Constructor for the file stat cache.
+ * @param[in] parent The parent object.
+ */
+FileStatCache::FileStatCache(QObject *parent) : QObject(parent)
+{
+	stat_timer_.setSingleShot(true);
+	stat_timer_.setInterval(0);
+	connect(&stat_timer_, &QTimer::timeout, this, &FileStatCache::startStats);
+	connect(&stat_watcher_, &QFutureWatcher<std::vector<std::pair<QString, FileStat>>>::finished,
+	    this, &FileStatCache::onStatsFinished);
+	connect(&fs_watcher_, &QFileSystemWatcher::directoryChanged, this, &FileStatCache::onDirectoryChanged);
+}
+
+/**
+ * @brief Destructor which waits for running file system queries to finish.
+ */
+FileStatCache::~FileStatCache()
+{
+	stat_watcher_.waitForFinished();
+}
+
+/**
+ * @brief Start using a path.
+ * @details The first user of a path triggers a query of the file system in the background.
+ * As long as the path is in use its directory is watched, and the users of the path (only those)
+ * are notified when its properties change.
+ * @param[in] path Absolute path to a file or directory.
+ * @param[in] user The object showing the path (usually a panel). A user can hold only one path.
+ * @param[in] on_change Called when the properties of the path are new or have changed, and for
+ * relative paths when the base directory changes.
+ * @param[in] is_relative The path was entered relative to the base directory.
+ */
+void FileStatCache::acquire(const QString &path, QObject *user, ChangeFunction on_change,
+    const bool &is_relative)
+{
+	Entry &entry( entries_[path] );
+	entry.users.insert(user, on_change);
+	if (is_relative)
+		relative_users_.insert(user, std::move(on_change));
+	if (entry.users.size() == 1)
+		queueStat(path);
+}
+
+/**
+ * @brief Stop using a path.
+ * @details When the last user releases a path it is not watched anymore and forgotten.
+ * @param[in] path Absolute path to a file or directory.
+ * @param[in] user The object that was showing the path.
+ */
+void FileStatCache::release(const QString &path, QObject *user)
+{
+	relative_users_.remove(user);
+	auto it( entries_.find(path) );
+	if (it == entries_.end())
+		return;
+	it->users.remove(user);
+	if (!it->users.isEmpty())
+		return;
+	unwatch(path, it->stat.watch_dir);
+	entries_.erase(it);
+	queued_paths_.remove(path);
+}
+
+/**
+ * @brief Get the properties of a path in use.
+ * @param[in] path Absolute path to a file or directory.
+ * @param[out] stat The properties of the path.
+ * @return True if the properties are known, false if the query is still running.
+ */
+bool FileStatCache::getStat(const QString &path, FileStat &stat) const
+{
+	const auto it( entries_.constFind(path) );
+	if (it == entries_.constEnd() || !it->known)
+		return false;
+	stat = it->stat;
+	return true;
+}
+
+/**
+ * @brief Set the directory that relative paths are resolved against.
+ * @details If it changes (e. g. an INI file was saved somewhere else), the users of relative
+ * paths are notified so that they can resolve their paths again.
+ * @param[in] base_dir The directory of the current INI file.
+ */
+void FileStatCache::setBaseDirectory(const QString &base_dir)
+{
+	if (base_dir == base_dir_)
+		return;
+	base_dir_ = base_dir;
+	const QHash<QObject *, ChangeFunction> relative_users( relative_users_ ); //users switch paths
+	for (auto it = relative_users.constBegin(); it != relative_users.constEnd(); ++it) {
+		if (relative_users_.contains(it.key())) //not released by an earlier notification
+			it.value()();
+	}
+}
+
+/**
+ * @brief Query the file system for a path with the next batch.
+ * @param[in] path Absolute path to a file or directory.
+ */
+void FileStatCache::queueStat(const QString &path)
+{
+	queued_paths_.insert(path);
+	if (!stat_watcher_.isRunning() && !stat_timer_.isActive())
+		stat_timer_.start();
+}
+
+/**
+ * @brief Query the file system for all queued paths on a worker thread.
+ */
+void FileStatCache::startStats()
+{
+	if (stat_watcher_.isRunning() || queued_paths_.isEmpty())
+		return;
+	const QStringList paths( queued_paths_.values() );
+	queued_paths_.clear();
+	stat_watcher_.setFuture(QtConcurrent::run(&FileStatCache::statFiles, paths));
+}
+
+/**
+ * @brief Stop watching the directory of a path if no other path depends on it.
+ * @param[in] path Absolute path to a file or directory.
+ * @param[in] watch_dir The directory that was watched for the path.
+ */
+void FileStatCache::unwatch(const QString &path, const QString &watch_dir)
+{
+	auto it( watched_dirs_.find(watch_dir) );
+	if (it == watched_dirs_.end())
+		return;
+	it->remove(path);
+	if (it->isEmpty()) {
+		fs_watcher_.removePath(watch_dir);
+		watched_dirs_.erase(it);
+	}
+}
+
+/**
+ * @brief Query the file system for a batch of paths (runs on a worker thread).
+ * @details Slow file systems (e. g. network mounts) only block the worker thread.
+ * @param[in] paths Absolute paths to files or directories.
+ * @return The paths and their properties.
+ */
+std::vector<std::pair<QString, FileStat>> FileStatCache::statFiles(const QStringList &paths)
+{
+	std::vector<std::pair<QString, FileStat>> results;
+	results.reserve(static_cast<size_t>(paths.size()));
+	for (auto &path : paths) {
+		FileStat stat;
+		const QFileInfo file_info( path );
+		stat.exists = file_info.exists();
+		if (stat.exists) {
+			stat.is_file = file_info.isFile();
+			stat.is_dir = file_info.isDir();
+			stat.is_readable = file_info.isReadable();
+			stat.is_writable = file_info.isWritable();
+			stat.is_executable = file_info.isExecutable();
+			stat.owner = file_info.owner();
+		}
+		stat.is_symlink = file_info.isSymLink();
+
+		//watch the closest existing parent directory to see the path appear or disappear:
+		stat.watch_dir = file_info.absolutePath();
+		while (!QFileInfo( stat.watch_dir ).isDir()) {
+			const QString parent_dir( QFileInfo( stat.watch_dir ).absolutePath() );
+			if (parent_dir == stat.watch_dir) { //reached the root without finding anything
+				stat.watch_dir = QString();
+				break;
+			}
+			stat.watch_dir = parent_dir;
+		}
+		results.emplace_back(path, stat);
+	}
+	return results;
+}
+
+/**
+ * @brief Store the results of a batch of file system queries.
+ * @details Paths that were released in the meantime are ignored. Watched directories are updated,
+ * and the users of all paths whose properties are new or have changed are notified.
+ */
+void FileStatCache::onStatsFinished()
+{
+	const std::vector<std::pair<QString, FileStat>> results( stat_watcher_.result() );
+	QStringList new_watches;
+	std::vector<std::pair<QPointer<QObject>, ChangeFunction>> notifications;
+	for (auto &result : results) {
+		auto it( entries_.find(result.first) );
+		if (it == entries_.end()) //not in use anymore
+			continue;
+		if (it->known && it->stat == result.second)
+			continue;
+		if (it->stat.watch_dir != result.second.watch_dir) {
+			unwatch(result.first, it->stat.watch_dir);
+			if (!result.second.watch_dir.isEmpty()) {
+				QSet<QString> &dir_paths( watched_dirs_[result.second.watch_dir] );
+				if (dir_paths.isEmpty())
+					new_watches.push_back(result.second.watch_dir);
+				dir_paths.insert(result.first);
+			}
+		}
+		it->known = true;
+		it->stat = result.second;
+		for (auto user = it->users.constBegin(); user != it->users.constEnd(); ++user)
+			notifications.emplace_back(QPointer<QObject>(user.key()), user.value());
+	}
+	if (!new_watches.isEmpty())
+		fs_watcher_.addPaths(new_watches);
+	for (auto &notification : notifications) { //users may switch paths when notified
+		if (!notification.first.isNull())
+			notification.second();
+	}
+
+	if (!queued_paths_.isEmpty()) //requested while the batch was running
+		stat_timer_.start();
+}
+
+/**
+ * @brief Query the file system again for all paths in a directory that has changed.
+ * @param[in] path The changed directory.
+ */
+void FileStatCache::onDirectoryChanged(const QString &path)
+{
+	const QSet<QString> dir_paths( watched_dirs_.value(path) );
+	for (auto &dir_path : dir_paths)
+		queueStat(dir_path);
+}
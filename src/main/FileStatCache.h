@@ -0,0 +1,116 @@
+/*****************************************************************************/
+/*  Copyright 2019 WSL Institute for Snow and Avalanche Research  SLF-DAVOS  */
+/*****************************************************************************/
+/* This file is part of INIshell.
+   INIshell is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   INIshell is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with INIshell.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*
+ * Shared cache of file properties for the panels that check paths. The file system is queried
+ * on worker threads and the directories of all paths in use are watched, so that panels are
+ * notified when files appear, disappear or change permissions. Panels showing relative paths
+ * are notified when the directory they are relative to changes.
+ * 2020-05
+ */
+
+#ifndef FILESTATCACHE_H
+#define FILESTATCACHE_H
+
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct FileStat
+ * @brief Properties of a file or directory as far as the panels are interested in them.
+ */
+struct FileStat {
+	bool operator==(const FileStat &other) const {
+		return exists == other.exists && is_file == other.is_file && is_dir == other.is_dir &&
+		    is_readable == other.is_readable && is_writable == other.is_writable &&
+		    is_executable == other.is_executable && is_symlink == other.is_symlink &&
+		    owner == other.owner && watch_dir == other.watch_dir;
+	}
+	bool operator!=(const FileStat &other) const { return !(*this == other); }
+
+	bool exists = false;
+	bool is_file = false;
+	bool is_dir = false;
+	bool is_readable = false;
+	bool is_writable = false;
+	bool is_executable = false;
+	bool is_symlink = false;
+	QString owner;
+	QString watch_dir; //closest existing directory above the path, watched for changes
+};
+
+class FileStatCache : public QObject {
+	Q_OBJECT
+
+	public:
+		using ChangeFunction = std::function<void()>; //called on the GUI thread
+
+		static FileStatCache & getShared();
+		~FileStatCache() override;
+		FileStatCache(const FileStatCache&) = delete;
+		FileStatCache& operator =(FileStatCache const&) = delete;
+		FileStatCache(FileStatCache&&) = delete;
+		FileStatCache& operator=(FileStatCache&&) = delete;
+		void acquire(const QString &path, QObject *user, ChangeFunction on_change, const bool &is_relative = false);
+		void release(const QString &path, QObject *user);
+		bool getStat(const QString &path, FileStat &stat) const;
+		void setBaseDirectory(const QString &base_dir);
+
+	private:
+		/**
+		 * @struct Entry
+		 * @brief A path in use by the panels.
+		 */
+		struct Entry {
+			QHash<QObject *, ChangeFunction> users; //panels showing this path
+			bool known = false; //stat has been done
+			FileStat stat;
+		};
+
+		explicit FileStatCache(QObject *parent = nullptr);
+		void queueStat(const QString &path);
+		void startStats();
+		void unwatch(const QString &path, const QString &watch_dir);
+		static std::vector<std::pair<QString, FileStat>> statFiles(const QStringList &paths);
+
+		QHash<QString, Entry> entries_; //absolute path -> properties
+		QHash<QString, QSet<QString>> watched_dirs_; //watched directory -> paths that depend on it
+		QHash<QObject *, ChangeFunction> relative_users_; //panels showing a path relative to base_dir_
+		QString base_dir_; //directory of the current INI file
+		QSet<QString> queued_paths_; //waiting for the next batch
+		QTimer stat_timer_; //collects requests of an event loop turn
+		QFutureWatcher<std::vector<std::pair<QString, FileStat>>> stat_watcher_;
+		QFileSystemWatcher fs_watcher_;
+
+	private slots:
+		void onStatsFinished();
+		void onDirectoryChanged(const QString &path);
+};
+
+#endif //FILESTATCACHE_H
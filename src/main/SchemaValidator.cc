@@ -0,0 +1,150 @@
+/*****************************************************************************/
+/*  Copyright 2019 WSL Institute for Snow and Avalanche Research  SLF-DAVOS  */
+/*****************************************************************************/
+/* This file is part of INIshell.
+   INIshell is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   INIshell is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with INIshell.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "SchemaValidator.h"
+#include "src/main/inishell.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QTextDocument>
+#include <QUrl>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtXmlPatterns/QXmlSchemaValidator>
+
+/**
+ * @class SchemaValidator
+ * @brief Get the schema validator all XML readers share.
+ * @return The shared schema validator (created on first use).
+ */
+SchemaValidator & SchemaValidator::getShared()
+{
+	static SchemaValidator *validator( new SchemaValidator(qApp) ); //deleted with the application
+	return *validator;
+}
+
+/**
+ * @brief Constructor for the schema validator.
+ * @param[in] parent The parent object.
+ */
+SchemaValidator::SchemaValidator(QObject *parent) : QObject(parent)
+{
+	pool_.setMaxThreadCount(1);
+	schema_.setMessageHandler(&schema_handler_);
+	//don't let a validation outlive the event loop:
+	connect(qApp, &QCoreApplication::aboutToQuit, this, &SchemaValidator::waitForValidations);
+}
+
+/**
+ * @brief Destructor which waits for running validations to finish.
+ */
+SchemaValidator::~SchemaValidator()
+{
+	waitForValidations();
+}
+
+/**
+ * @brief Validate XML files against the schema in the background.
+ * @details Errors are sent to the logger when the validation is done.
+ * @param[in] sources File names and raw contents of the XML files to validate.
+ */
+void SchemaValidator::validate(const std::vector<std::pair<QString, QByteArray>> &sources)
+{
+	for (auto it = validations_.begin(); it != validations_.end();) { //forget finished validations
+		if (it->isFinished())
+			it = validations_.erase(it);
+		else
+			++it;
+	}
+	validations_.push_back(QtConcurrent::run(&pool_, [this, sources]() {
+		const std::vector<SchemaError> errors( runValidation(sources) );
+		if (errors.empty())
+			return;
+		//hand the result over to the GUI thread:
+		QMetaObject::invokeMethod(this, [this, errors]() {
+			logErrors(errors);
+		}, Qt::QueuedConnection);
+	}));
+}
+
+/**
+ * @brief Validate XML files against the schema (runs on the pool's thread).
+ * @details The schema is compiled on the first run. Each file gets its own message handler, so
+ * that no message of an earlier validation can be reported for it.
+ * @param[in] sources File names and raw contents of the XML files to validate.
+ * @return The files that failed validation, or a single error without file name if the schema
+ * itself is invalid.
+ */
+std::vector<SchemaValidator::SchemaError> SchemaValidator::runValidation(
+    const std::vector<std::pair<QString, QByteArray>> &sources)
+{
+	std::vector<SchemaError> errors;
+	if (!schema_loaded_) {
+		schema_.load( QUrl("qrc:config_schema.xsd") );
+		schema_loaded_ = true;
+	}
+	if (!schema_.isValid()) {
+		errors.push_back(SchemaError());
+		return errors;
+	}
+	QXmlSchemaValidator validator(schema_);
+	for (auto &source : sources) {
+		MessageHandler msg_handler;
+		validator.setMessageHandler(&msg_handler);
+		if (validator.validate(source.second, QUrl::fromLocalFile(source.first)))
+			continue;
+		SchemaError error;
+		error.file = source.first;
+		error.message = msg_handler.status();
+		error.line = msg_handler.line();
+		error.column = msg_handler.column();
+		errors.push_back(error);
+	}
+	return errors;
+}
+
+/**
+ * @brief Send schema validation errors to the logger.
+ * @details The messages come as HTML, which is converted to plain text here on the GUI thread.
+ * @param[in] errors The validation errors.
+ */
+void SchemaValidator::logErrors(const std::vector<SchemaError> &errors) const
+{
+	QStringList messages;
+	for (auto &error : errors) {
+		if (error.file.isEmpty()) {
+			messages.push_back(QCoreApplication::tr("XML error: there is an error in the internal xsd file. Skipping schema validation."));
+			continue;
+		}
+		QTextDocument error_msg;
+		error_msg.setHtml(error.message); //strip HTML
+		messages.push_back(QString("[XML error: schema validation failed for \"%1\"] ").arg(
+		    QDir::toNativeSeparators(error.file)) + error_msg.toPlainText() +
+		    QString(" (line %1, column %2)").arg(error.line).arg(error.column));
+	}
+	topLog(messages.join("\n"), "error");
+}
+
+/**
+ * @brief Wait until all validations that were started have finished.
+ */
+void SchemaValidator::waitForValidations()
+{
+	for (auto &validation : validations_)
+		validation.waitForFinished();
+	validations_.clear();
+}
@@ -0,0 +1,81 @@
+/*****************************************************************************/
+/*  Copyright 2019 WSL Institute for Snow and Avalanche Research  SLF-DAVOS  */
+/*****************************************************************************/
+/* This file is part of INIshell.
+   INIshell is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   INIshell is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with INIshell.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*
+ * Validates application XML files against INIshell's schema in the background. The schema is
+ * compiled once and owned by a single shared object that lives as long as the application, and
+ * validations still running are waited for when the application quits.
+ * 2020-05
+ */
+
+#ifndef SCHEMAVALIDATOR_H
+#define SCHEMAVALIDATOR_H
+
+#include "src/main/common.h"
+
+#include <QByteArray>
+#include <QFuture>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <QtXmlPatterns/QXmlSchema>
+
+#include <utility>
+#include <vector>
+
+class SchemaValidator : public QObject {
+	Q_OBJECT
+
+	public:
+		static SchemaValidator & getShared();
+		~SchemaValidator() override;
+		SchemaValidator(const SchemaValidator&) = delete;
+		SchemaValidator& operator =(SchemaValidator const&) = delete;
+		SchemaValidator(SchemaValidator&&) = delete;
+		SchemaValidator& operator=(SchemaValidator&&) = delete;
+		void validate(const std::vector<std::pair<QString, QByteArray>> &sources);
+
+	private:
+		/**
+		 * @struct SchemaError
+		 * @brief A failed validation of one XML file.
+		 */
+		struct SchemaError {
+			QString file; //empty if the schema itself is invalid
+			QString message; //HTML formatted by QtXmlPatterns
+			int line = 0;
+			int column = 0;
+		};
+
+		explicit SchemaValidator(QObject *parent = nullptr);
+		std::vector<SchemaError> runValidation(const std::vector<std::pair<QString, QByteArray>> &sources);
+		void logErrors(const std::vector<SchemaError> &errors) const;
+
+		QThreadPool pool_; //a single thread, so validations run one at a time
+		MessageHandler schema_handler_; //messages of compiling the schema
+		QXmlSchema schema_; //compiled on the pool's thread on first use
+		bool schema_loaded_ = false;
+		QList<QFuture<void>> validations_; //started and maybe still running
+
+	private slots:
+		void waitForValidations();
+};
+
+#endif //SCHEMAVALIDATOR_H
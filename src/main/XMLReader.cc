@@ -20,10 +20,9 @@
 #include "src/main/colors.h"
 #include "src/main/common.h"
 #include "src/main/inishell.h"
+#include "src/main/SchemaValidator.h"
 
 #include <QCoreApplication> //for translations
-#include <QtXmlPatterns/QXmlSchema>
-#include <QtXmlPatterns/QXmlSchemaValidator>
 
 /**
  * @brief Add a dummy parent node to an XML node for when a function expects to iterate through children.
@@ -90,8 +89,10 @@ QString XMLReader::read(QFile &file, QString &xml_error, const bool &no_referenc
 	QString error_msg;
 	int error_line, error_column;
 	xml_error = QString();
+	xml_sources_.clear();
 
-	if (!xml_.setContent(&file, false, &error_msg, &error_line, &error_column)) {
+	const QByteArray raw_xml( file.readAll() ); //keep the original bytes for schema validation
+	if (!xml_.setContent(raw_xml, false, &error_msg, &error_line, &error_column)) {
 		xml_error = QString(QCoreApplication::tr(
 		    "XML error: %1 (line %2, column %3)")).arg(error_msg).arg(error_line).arg(error_column) + "\n";
 	}
@@ -99,8 +100,9 @@ QString XMLReader::read(QFile &file, QString &xml_error, const bool &no_referenc
 	if (no_references) //e. g. static GUI settings file
 		return QString();
 
+	xml_sources_.emplace_back(master_xml_file_, raw_xml);
 	parseIncludes(xml_, master_xml_file_, xml_error); //"<include file='...'/>" tags
-	validateSchema(xml_error);
+	validateSchema(); //runs in the background and reports to the logger
 	parseReferences(); //"<reference name='...'/>" tags
 	return parseAutoloadIni();
 }
@@ -191,7 +193,9 @@ void XMLReader::parseIncludes(const QDomDocument &xml_, const QString &parent_fi
 			QDomDocument inc; //the new document to include
 			QString error_msg;
 			int error_line, error_column;
-			if (!inc.setContent(include_file.readAll(), false, &error_msg, &error_line, &error_column)) {
+			const QByteArray raw_include( include_file.readAll() );
+			xml_sources_.emplace_back(include_file.fileName(), raw_include);
+			if (!inc.setContent(raw_include, false, &error_msg, &error_line, &error_column)) {
 				xml_error += QString(QCoreApplication::tr(
 				    R"(XML error: [Include file "%1"] %2 (line %3, column %4))")).arg(
 				    QDir::toNativeSeparators(include_file_name), error_msg).arg(error_line).arg(error_column) + "\n";
@@ -257,30 +261,29 @@ QDomDocument XMLReader::getXml() const
 }
 
 /**
- * @brief Perform schema validation on an XML file.
- * @param[out] xml_error XML operations error string to add to.
+ * @brief Get the files the XML was assembled from.
+ * @return The master XML file followed by all of its include files.
+ */
+QStringList XMLReader::getSourceFiles() const
+{
+	QStringList files;
+	for (auto &source : xml_sources_)
+		files.push_back(source.first);
+	return files;
+}
+
+/**
+ * @brief Perform schema validation on the XML files that were read.
+ * @details The validation runs on a worker thread so that the GUI can be built in the meantime.
+ * The original contents of the master file and all include files are validated (instead of
+ * re-serializing the merged DOM), and any errors are sent to the logger when they are available.
  */
-void XMLReader::validateSchema(QString &xml_error) const
+void XMLReader::validateSchema() const
 {
 	/*
 	 * The logger already displays a lot of info and the XML parser itself also logs errors,
 	 * but what it doesn't do is check for outdated parameter names, unknown attributes, etc.,
 	 * so the schema validation is still useful.
 	 */
-	MessageHandler msgHandler;
-	QXmlSchema schema;
-	schema.setMessageHandler(&msgHandler);
-	schema.load( QUrl("qrc:config_schema.xsd") );
-	if (!schema.isValid()) {
-		xml_error += QCoreApplication::tr("XML error: there is an error in the internal xsd file. Skipping schema validation.") + "\n";
-	} else {
-		const QXmlSchemaValidator validator(schema);
-		const bool validation_success = validator.validate(xml_.toString().toUtf8());
-		if (!validation_success) {
-			QTextDocument error_msg;
-			error_msg.setHtml(msgHandler.status()); //strip HTML
-			xml_error += "[XML error: schema validation failed] " + error_msg.toPlainText() +
-			    QString(" (line %1, column %2)").arg(msgHandler.line(), msgHandler.column()) + "\n";
-		}
-	}
+	SchemaValidator::getShared().validate(xml_sources_);
 }
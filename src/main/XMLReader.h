@@ -28,8 +28,12 @@
 #include <QFile>
 #include <QMap>
 #include <QString>
+#include <QStringList>
 #include <QtXml>
 
+#include <utility>
+#include <vector>
+
 #ifdef DEBUG
 	#include <QTextStream>
 	#include <iostream>
@@ -48,6 +52,7 @@ class XMLReader {
 		QString parseAutoloadIni() const;
 		QDomDocumentFragment fragmentFromNodeChildren(const QDomNode &node);
 		QDomDocument getXml() const;
+		QStringList getSourceFiles() const;
 #ifdef DEBUG
 		template<class T>
 		static void debugPrintNode(T node) { //call with QDomElement or QDomNode
@@ -62,10 +67,11 @@ class XMLReader {
 #endif //def DEBUG
 
 	private:
-		void validateSchema(QString &xml_error) const;
+		void validateSchema() const;
 
 		QString master_xml_file_;
 		QDomDocument xml_;
+		std::vector<std::pair<QString, QByteArray>> xml_sources_; //raw contents of master and include files
 };
 
 #endif //XMLREADER_H
@@ -21,10 +21,46 @@
 #include "src/main/settings.h"
 
 #include <QDebug>
+#include <QHash>
 #include <QPalette>
 
+#include <array>
+
 namespace colors {
 
+/**
+ * @brief Look-up table from the color names to the color table.
+ * @return Map of INIshell's color names to the color enum.
+ */
+static const QHash<QString, Color> & getColorNames()
+{
+	static const QHash<QString, Color> names{
+		{"app_bg", Color::app_bg}, {"normal", Color::normal}, {"info", Color::info},
+		{"error", Color::error}, {"warning", Color::warning}, {"special", Color::special},
+		{"important", Color::important}, {"helptext", Color::helptext},
+		{"mandatory", Color::mandatory}, {"default_values", Color::default_values},
+		{"faulty_values", Color::faulty_values}, {"valid_values", Color::valid_values},
+		{"number", Color::number}, {"groupborder", Color::groupborder},
+		{"frameborder", Color::frameborder}, {"syntax_known_key", Color::syntax_known_key},
+		{"syntax_unknown_key", Color::syntax_unknown_key},
+		{"syntax_known_section", Color::syntax_known_section},
+		{"syntax_unknown_section", Color::syntax_unknown_section},
+		{"syntax_value", Color::syntax_value}, {"coordinate", Color::coordinate},
+		{"syntax_background", Color::syntax_background}, {"syntax_invalid", Color::syntax_invalid},
+		{"syntax_comment", Color::syntax_comment}, {"sl_base03", Color::sl_base03},
+		{"sl_base02", Color::sl_base02}, {"sl_base01", Color::sl_base01},
+		{"sl_base00", Color::sl_base00}, {"sl_base0", Color::sl_base0}, {"sl_base1", Color::sl_base1},
+		{"sl_base2", Color::sl_base2}, {"sl_base3", Color::sl_base3}, {"sl_yellow", Color::sl_yellow},
+		{"sl_orange", Color::sl_orange}, {"sl_red", Color::sl_red}, {"sl_magenta", Color::sl_magenta},
+		{"sl_violet", Color::sl_violet}, {"sl_blue", Color::sl_blue}, {"sl_cyan", Color::sl_cyan},
+		{"sl_green", Color::sl_green}
+	};
+	return names;
+}
+
+static bool color_table_valid = false; //the table is rebuilt on next access if false
+static std::array<QColor, static_cast<size_t>(Color::count)> color_table;
+
 /**
  * @brief Decide whether to use dark mode dependent on user preference and system settings.
  * @return True if dark mode should be enabled.
@@ -41,108 +77,116 @@ bool useDarkTheme()
 }
 
 /**
- * @brief Get color for a specific event or item.
- * @param[in] INIshell's name for the color.
- * @return Qt usable color.
+ * @brief Mark the color table as outdated.
+ * @details This must be called when the dark mode setting or the system's palette changes.
  */
-QColor getQColor(const QString &colorname)
+void invalidateTheme()
+{
+	color_table_valid = false;
+}
+
+/**
+ * @brief Fill the color table for the current theme.
+ * @details The solarized colors are the base, the other colors refer to them (or are special
+ * colors for the dark mode).
+ */
+static void buildColorTable()
 {
-	QString name(colorname.toLower());
+	static bool watching_settings = false;
+	if (!watching_settings) { //rebuild when the user switches the dark mode
+		QObject::connect(SettingsNotifier::getShared(), &SettingsNotifier::settingChanged,
+		    [](const QString &setting_name, const QString &, const QString &) {
+			if (setting_name == "user::appearance::darkmode")
+				invalidateTheme();
+		});
+		watching_settings = true;
+	}
 	const bool use_darkmode = useDarkTheme(); //decide whether to use dark mode
+	const auto set = [](const Color &color, const QColor &value) {
+		color_table[static_cast<size_t>(color)] = value; };
+	const auto get = [](const Color &color) { return color_table[static_cast<size_t>(color)]; };
+
+	/* solarized named colors */
+	set(Color::sl_base03, QColor(0x002b36));
+	set(Color::sl_base02, QColor(0x073642));
+	set(Color::sl_base01, QColor(0x586e75));
+	set(Color::sl_base00, QColor(0x657b83));
+	set(Color::sl_base0, QColor(0x839496));
+	set(Color::sl_base1, QColor(0x93a1a1));
+	set(Color::sl_base2, QColor(0xeee8d5));
+	set(Color::sl_base3, QColor(0xfdf6e3));
+	set(Color::sl_yellow, QColor(0xb58900));
+	set(Color::sl_orange, QColor(0xcb4b16));
+	set(Color::sl_red, QColor(0xdc322f));
+	set(Color::sl_magenta, QColor(0xd33682));
+	set(Color::sl_violet, QColor(0x6c71c4));
+	set(Color::sl_blue, QColor(0x268bd2));
+	set(Color::sl_cyan, QColor(0x2aa198));
+	set(Color::sl_green, QColor(0x859900));
 
 	/* substitutions */
-	if (name == "app_bg")
-		return (use_darkmode)? QColor(0x31363b) : QColor("white");
-	else if (name == "normal")
-		return (use_darkmode)? QColor("white") : QColor();
-	else if (name == "info")
-		name = "sl_base01";
-	else if (name == "error")
-		name = "sl_red";
-	else if (name == "warning")
-		name = "sl_orange";
-	else if (name == "special")
-		name = "sl_blue";
-	else if (name == "important")
-		name = "sl_red";
-	else if (name == "helptext")
-		name = "sl_base1";
-	else if (name == "mandatory")
-		name = "sl_orange";
-	else if (name == "default_values")
-		name = "sl_base00";
-	else if (name == "faulty_values")
-		name = "sl_orange";
-	else if (name == "valid_values")
-		return (use_darkmode)? QColor("white") : QColor();
-	else if (name == "number")
-		name = "sl_cyan";
-	else if (name == "groupborder")
-		name = "sl_base1";
-	else if (name == "frameborder")
-		name = "sl_base1";
+	set(Color::app_bg, (use_darkmode)? QColor(0x31363b) : QColor("white"));
+	set(Color::normal, (use_darkmode)? QColor("white") : QColor());
+	set(Color::info, get(Color::sl_base01));
+	set(Color::error, get(Color::sl_red));
+	set(Color::warning, get(Color::sl_orange));
+	set(Color::special, get(Color::sl_blue));
+	set(Color::important, get(Color::sl_red));
+	set(Color::helptext, get(Color::sl_base1));
+	set(Color::mandatory, get(Color::sl_orange));
+	set(Color::default_values, get(Color::sl_base00));
+	set(Color::faulty_values, get(Color::sl_orange));
+	set(Color::valid_values, (use_darkmode)? QColor("white") : QColor());
+	set(Color::number, get(Color::sl_cyan));
+	set(Color::groupborder, get(Color::sl_base1));
+	set(Color::frameborder, get(Color::sl_base1));
 
 	/* syntax highlighter */
-	if (name == "syntax_known_key")
-		name = "sl_blue";
-	else if (name == "syntax_unknown_key")
-		name = "sl_yellow";
-	else if (name == "syntax_known_section")
-		name = (use_darkmode)? "sl_base2" : "sl_base02";
-	else if (name == "syntax_unknown_section")
-		name = "sl_orange";
-	else if (name == "syntax_value")
-		name = "sl_green";
-	else if (name == "coordinate")
-		name = "sl_cyan";
-	else if (name == "syntax_background") {
-		if (use_darkmode) return QColor(0x41464b);
-		name = "sl_base3";
-	} else if (name == "syntax_invalid")
-		name = "sl_red";
-	else if (name == "syntax_comment")
-		name = "sl_base1";
+	set(Color::syntax_known_key, get(Color::sl_blue));
+	set(Color::syntax_unknown_key, get(Color::sl_yellow));
+	set(Color::syntax_known_section, get((use_darkmode)? Color::sl_base2 : Color::sl_base02));
+	set(Color::syntax_unknown_section, get(Color::sl_orange));
+	set(Color::syntax_value, get(Color::sl_green));
+	set(Color::coordinate, get(Color::sl_cyan));
+	set(Color::syntax_background, (use_darkmode)? QColor(0x41464b) : get(Color::sl_base3));
+	set(Color::syntax_invalid, get(Color::sl_red));
+	set(Color::syntax_comment, get(Color::sl_base1));
 
-	/* solarized named colors */
-	if (name == "sl_base03")
-		return QColor(0x002b36);
-	else if (name == "sl_base02")
-		return QColor(0x073642);
-	else if (name == "sl_base01")
-		return QColor(0x586e75);
-	else if (name == "sl_base00")
-		return QColor(0x657b83);
-	else if (name == "sl_base0")
-		return QColor(0x839496);
-	else if (name == "sl_base1")
-		return QColor(0x93a1a1);
-	else if (name == "sl_base2")
-		return QColor(0xeee8d5);
-	else if (name == "sl_base3")
-		return QColor(0xfdf6e3);
-	else if (name == "sl_yellow")
-		return QColor(0xb58900);
-	else if (name == "sl_orange")
-		return QColor(0xcb4b16);
-	else if (name == "sl_red")
-		return QColor(0xdc322f);
-	else if (name == "sl_magenta")
-		return QColor(0xd33682);
-	else if (name == "sl_violet")
-		return QColor(0x6c71c4);
-	else if (name == "sl_blue")
-		return QColor(0x268bd2);
-	else if (name == "sl_cyan")
-		return QColor(0x2aa198);
-	else if (name == "sl_green")
-		return QColor(0x859900);
+	color_table_valid = true;
+}
+
+/**
+ * @brief Get color for a specific event or item.
+ * @param[in] color INIshell's name for the color.
+ * @return Qt usable color.
+ */
+QColor getQColor(const Color &color)
+{
+	if (!color_table_valid)
+		buildColorTable();
+	return color_table[static_cast<size_t>(color)];
+}
+
+/**
+ * @brief Get color for a specific event or item by its name.
+ * @param[in] INIshell's name for the color, or anything Qt understands (e. g. hex codes).
+ * @return Qt usable color.
+ */
+QColor getQColor(const QString &colorname)
+{
+	const QHash<QString, Color> &names( getColorNames() );
+	auto it( names.constFind(colorname) );
+	if (it == names.constEnd())
+		it = names.constFind(colorname.toLower());
+	if (it != names.constEnd())
+		return getQColor(it.value());
 
 #ifdef DEBUG //Qt will also correctly choose for strings like "red" but usually we want to be specific
-	if (!name.isEmpty() && name.at(0) != "#")
-		qDebug() << "Custom color not found:" << name;
+	if (!colorname.isEmpty() && colorname.at(0) != "#")
+		qDebug() << "Custom color not found:" << colorname;
 #endif
 
-	return {name}; //let Qt pick (e. g. hex codes), black if not valid
+	return {colorname.toLower()}; //let Qt pick (e. g. hex codes), black if not valid
 }
 
 } //namespace colors
@@ -25,10 +25,27 @@
 #define COLORS_H
 
 #include <QColor>
+#include <QString>
 
 namespace colors {
 
+/*
+ * INIshell's named colors. The names are the lower case strings that can be used in the XML
+ * files (e. g. color="sl_blue").
+ */
+enum class Color : int {
+	app_bg, normal, info, error, warning, special, important, helptext, mandatory,
+	default_values, faulty_values, valid_values, number, groupborder, frameborder,
+	syntax_known_key, syntax_unknown_key, syntax_known_section, syntax_unknown_section,
+	syntax_value, coordinate, syntax_background, syntax_invalid, syntax_comment,
+	sl_base03, sl_base02, sl_base01, sl_base00, sl_base0, sl_base1, sl_base2, sl_base3,
+	sl_yellow, sl_orange, sl_red, sl_magenta, sl_violet, sl_blue, sl_cyan, sl_green,
+	count //number of colors
+};
+
 bool useDarkTheme();
+void invalidateTheme();
+QColor getQColor(const Color &color);
 QColor getQColor(const QString &colorname);
 
 } //namespace colors
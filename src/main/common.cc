@@ -23,6 +23,7 @@
 
 #include <QDir>
 #include <QFileInfo>
+#include <QSet>
 
 namespace html {
 
@@ -71,7 +72,7 @@ void MessageHandler::handleMessage(QtMsgType type, const QString &description, c
  * @brief Fill a list with directories to search for XMLs.
  * @details This function queries a couple of default folders on various systems, as well as
  * ones that can be set by the user. Duplicates (e. g. the same folder given by a relative
- * and an absolute path) are ignored.
+ * and an absolute path, or via a symbolic link) are ignored.
  * @return A list of directories to search for XMLs.
  */
 QStringList getSearchDirs(const bool &include_user_set, const bool &include_nonexistent_folders)
@@ -82,7 +83,7 @@ QStringList getSearchDirs(const bool &include_user_set, const bool &include_none
 	locations << "."; //the application's current directory
 	os::getSystemLocations(locations); //update list with OS specific search paths
 
-	//TODO: recursive search
+	//subfolders are searched by the AppScanner if requested in the settings:
 	QStringList dirs;
 	for (auto &tmp_dir : locations) {
 		dirs << tmp_dir + "/inishell-apps";
@@ -95,21 +96,18 @@ QStringList getSearchDirs(const bool &include_user_set, const bool &include_none
 		dirs.append(user_xml_paths);
 	}
 
-	//now, check that we don't have the same folder multiple times (e. g. via relative and absolute paths):
+	//now, check that we don't have the same folder multiple times (e. g. via relative and absolute paths or links):
 	QStringList filtered_dirs;
+	QSet<QString> known_dirs;
 	for (auto &dir : dirs) {
 		const QFileInfo dinfo( dir );
 		if (!include_nonexistent_folders && !dinfo.exists())
 			continue;
-		bool found = false;
-		for (const auto &filtered_dir : filtered_dirs) {
-			if (dinfo.absoluteFilePath() == QFileInfo( filtered_dir ).absoluteFilePath()) {
-				found = true;
-				break;
-			}
-		}
-		if (!found)
-			filtered_dirs << dir;
+		const QString canonical( dinfo.exists()? dinfo.canonicalFilePath() : QDir::cleanPath(dinfo.absoluteFilePath()) );
+		if (known_dirs.contains(canonical))
+			continue;
+		known_dirs.insert(canonical);
+		filtered_dirs << dir;
 	}
 
 	return filtered_dirs;
@@ -67,8 +67,10 @@ namespace Cst {
 	static constexpr int width_checklist_max = 300;
 	static constexpr int checklist_safety_padding_vertical = 3;
 	static constexpr int checklist_safety_padding_horizontal = 50; //space for checkboxes
+	static constexpr int checklist_filter_min_items = 20; //show a filter field for longer lists
 	static constexpr int width_dropdown_max = 300; //DROPDOWN panel
 	static constexpr int dropdown_safety_padding = 30;
+	static constexpr int dropdown_filter_min_items = 50; //type-ahead filtering for longer lists
 	static constexpr int width_filepath_min = tiny * 2; //FILEPATH panel
 	static constexpr int frame_left_margin = 20; //FRAME panel
 	static constexpr int frame_right_margin = frame_left_margin;
@@ -81,12 +83,20 @@ namespace Cst {
 	static constexpr int width_number_min = 125; //NUMBER panel
 	static constexpr int width_textbox_medium = 200; //TEXTFIELD panel
 	static constexpr int default_spacer_size = 40; //SPACER panel
+	static constexpr int incremental_rows_min_count = 200; //sections with more top level elements are built incrementally while scrolling
+	static constexpr int placeholder_row_height = 30; //placeholder height of elements that are not built yet
+	static constexpr int template_pool_size = 256; //REPLICATOR/SELECTOR items kept for reuse per panel
 
 	/* workflow panel */
 	static constexpr int treeview_indentation_ = 15;
+	static constexpr int icon_thumbnail_size = 64; //application icons are decoded at most this big
+	static constexpr int icon_cache_memory_kb = 4096;
+	static constexpr int icon_cache_disk_kb = 10240;
+	static constexpr int icon_cache_disk_pruned_kb = 7680; //a full disk cache is pruned to this size
 
 	/* static strings */
 	static const QString settings_file_name = "inishell_config.xml";
+	static const QString app_cache_file_name = "inishell_app_cache.xml"; //headers of scanned XML files
 	static const QString sep = "::"; //do a grep if this is changed -- it's hardcoded in some messages
 	static const QString section_open = "["; //check all RegularExpressions if this is changed
 	static const QString section_close = "]";
@@ -95,6 +105,9 @@ namespace Cst {
 	/* time */
 	static constexpr int msg_length = 5000; //default ms for toolbar messages
 	static constexpr int msg_short_length = 3000;
+	static constexpr int app_scan_delay = 500; //wait for file system changes to settle before rescanning
+	static constexpr int settings_save_delay = 2000; //collect settings changes before writing the file
+	static constexpr int validation_delay = 250; //wait for typing to pause before checking a text
 
 } //end namespace
 
@@ -60,7 +60,7 @@ void setDimensions(QWidget *window, const window_type &type)
 		factor = 1/2.;
 	}
 
-	if (getSetting("user::appearance::remembersizes", "value") == "TRUE") {
+	if (getBoolSetting("user::appearance::remembersizes")) {
 		//check if we can restore the window size from the last run:
 		bool width_success, height_success;
 		const int width_from_settings = getSetting("auto::sizes::window_" + QString::number(type), "width").toInt(&width_success);
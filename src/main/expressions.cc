@@ -18,14 +18,110 @@
 
 #include "expressions.h"
 #include "inishell.h"
+#include "src/main/constants.h"
+#include "src/main/INIParser.h"
 #include "src/gui_elements/Atomic.h"
+#include "src/gui_elements/Group.h"
 
 #include "lib/tinyexpr.h"
 
+#include <QCoreApplication>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QRegularExpression>
 
 namespace expr {
 
+/**
+ * @brief Name of the tinyexpr variable standing for a referenced INI key.
+ * @param[in] index Index of the referenced key.
+ * @return Variable name.
+ */
+static QString variableName(const int &index)
+{
+	return "inishell_key_" + QString::number(index); //tinyexpr: lower case, digits and '_' only
+}
+
+/**
+ * @brief Check if a reference in an expression stands for an environment variable.
+ * @param[in] reference The reference without ${...}.
+ * @return True for references like env:VAR.
+ */
+static bool isEnvReference(const QString &reference)
+{
+	return reference.startsWith("env:");
+}
+
+/**
+ * @brief Replace references to INI keys in an arithmetic expression with variables.
+ * @param[in] expression The arithmetic expression with references like ${SECTION::KEY} or ${env:VAR}.
+ * @param[out] keys The referenced keys (lower case, environment variables as they are) in the order
+ * of the variables.
+ * @return The expression with variables instead of references.
+ */
+static QString bindReferences(const QString &expression, QStringList &keys)
+{
+	static const QRegularExpression rex_reference(R"(\$\{([^{}]+)\})");
+	QString bound_expression;
+	int last_end = 0;
+	QRegularExpressionMatchIterator it( rex_reference.globalMatch(expression) );
+	while (it.hasNext()) {
+		const QRegularExpressionMatch match( it.next() );
+		QString key( match.captured(1).trimmed() );
+		if (!isEnvReference(key)) //environment variables are case sensitive
+			key = key.toLower();
+		int index = keys.indexOf(key);
+		if (index == -1) {
+			keys.push_back(key);
+			index = keys.size() - 1;
+		}
+		bound_expression += expression.mid(last_end, match.capturedStart() - last_end) + variableName(index);
+		last_end = match.capturedEnd();
+	}
+	bound_expression += expression.mid(last_end);
+	return bound_expression;
+}
+
+/**
+ * @brief Parse an arithmetic expression with tinyexpr.
+ * @param[in] expression The arithmetic expression with variables for the referenced keys.
+ * @param[in] key_count Number of referenced keys.
+ * @param[in] values Storage for the values of the referenced keys (key_count elements).
+ * @return The syntax tree, or nullptr if the expression is invalid. Free with te_free().
+ */
+static te_expr * compileTree(const QString &expression, const int &key_count, const double *values)
+{
+	std::vector<QByteArray> names;
+	std::vector<te_variable> variables;
+	names.reserve(static_cast<size_t>(key_count)); //the variables point into the names
+	for (int ii = 0; ii < key_count; ++ii) {
+		names.push_back(variableName(ii).toLatin1());
+		const te_variable variable = {names.back().constData(), &values[ii], TE_VARIABLE, nullptr};
+		variables.push_back(variable);
+	}
+	int status_code;
+	return te_compile(expression.toStdString().c_str(), variables.data(), key_count, &status_code);
+}
+
+/**
+ * @brief Check if there is a panel for an INI key.
+ * @details Panels are looked up in the key registry, only if the key is not found there its
+ * section is built (it may not have been needed yet). References to environment variables
+ * exist if the variable is set.
+ * @param[in] ini_key The INI key.
+ * @return True if a panel handles the key.
+ */
+static bool keyExists(const QString &ini_key)
+{
+	if (isEnvReference(ini_key))
+		return !qgetenv(ini_key.mid(4).toLocal8Bit()).isNull(); //"env:" + name
+	for (auto *panel : Atomic::getPanels(ini_key)) {
+		if (qobject_cast<Group *>(panel) == nullptr) //groups don't count towards finding INI keys
+			return true;
+	}
+	return !getMainWindow()->getPanelsForKey(ini_key).isEmpty();
+}
+
 /**
  * @brief Evaluate a string according to special syntax tokens.
  * @details This function checks for arithmetic expressions which are in accordance with SLF software,
@@ -38,55 +134,581 @@ namespace expr {
 bool checkExpression(const QString &expression, bool &evaluation_success,
     const std::vector< std::pair<QString, QString> > &substitutions, const bool &needs_prefix)
 {
-	static const QString regex_envvar(R"(\${env:(.+)})");   //ex.: ${env:USER}
-	QString regex_expression;
-	if (needs_prefix)
-		regex_expression = R"(\${{(.+)}})"; //ex.: ${{sin(pi)}}
-	else
-		regex_expression = R"((.+))"; //enable checks without ${{}
-	static const QString regex_inikey(R"(\${(.+)})");       //ex.: ${GENERAL::BUFFER_SIZE}
-	static const QRegularExpression rex_envvar(regex_envvar);
-	const QRegularExpression rex_expression(regex_expression);
-	static const QRegularExpression rex_inikey(regex_inikey);
-	const QRegularExpressionMatch match_envvar(rex_envvar.match(expression));
-	const QRegularExpressionMatch match_expression(rex_expression.match(expression));
-	const QRegularExpressionMatch match_inikey(rex_inikey.match(expression));
-	static const QString regex_scientific( R"(-?[\d.]+(?:[Ee]-?\d+)?)" );
-	static const QRegularExpression rex_scientific( regex_scientific );
-	const QRegularExpressionMatch match_scientific(rex_scientific.match(expression));
-	static const size_t idx_total = 0;
-	static const size_t idx_check = 1;
-
-	if (expression.isEmpty()) {
-		evaluation_success = false;
-		return false;
-	}
+	ExpressionCheck check( parseExpression(expression, substitutions, needs_prefix) );
+	resolveExpression(check);
+	evaluation_success = check.evaluation_success;
+	return check.is_expression;
+}
 
+/**
+ * @brief Check the syntax of a string and evaluate it as far as possible without accessing the GUI.
+ * @details This is the thread safe part of checkExpression(). The regular expressions are compiled
+ * once and only matched until one of them fits. References to INI keys are returned to be looked up
+ * with resolveExpression().
+ * @param[in] expression The string to check.
+ * @param[in] substitutions Substitutions to perform before evaluating arithmetic expressions.
+ * @param[in] needs_prefix If true, check arithmetic expression only if ${{...}}. If false, check without prefix.
+ * @param[in,out] compiled If given, arithmetic expressions are compiled into this and the syntax tree
+ * is reused as long as the expression does not change (GUI thread only).
+ * @return The result of the check.
+ */
+ExpressionCheck parseExpression(const QString &expression,
+    const std::vector< std::pair<QString, QString> > &substitutions, const bool &needs_prefix,
+    CompiledExpression *compiled)
+{
+	static const auto compile = [](const QString &pattern) -> QRegularExpression {
+		QRegularExpression rex(pattern);
+		rex.optimize(); //JIT compile now instead of on the first match
+		return rex;
+	};
+	static const QRegularExpression rex_envvar( compile(R"(\${env:(.+)})") );   //ex.: ${env:USER}
+	static const QRegularExpression rex_prefixed_expression( compile(R"(\${{(.+)}})") ); //ex.: ${{sin(pi)}}
+	static const QRegularExpression rex_plain_expression( compile(R"((.+))") ); //enable checks without ${{}
+	static const QRegularExpression rex_inikey( compile(R"(\${(.+)})") );       //ex.: ${GENERAL::BUFFER_SIZE}
+	static const QRegularExpression rex_scientific( compile(R"(-?[\d.]+(?:[Ee]-?\d+)?)") );
+	static const int idx_total = 0;
+	static const int idx_check = 1;
+
+	ExpressionCheck check;
+	if (expression.isEmpty())
+		return check;
+
+	const QRegularExpressionMatch match_envvar( rex_envvar.match(expression) );
 	if (match_envvar.captured(idx_total) == expression) {
 		/* check if environment variable is set */
 		const QByteArray envvar( qgetenv(match_envvar.captured(idx_check).toLocal8Bit()) );
-		evaluation_success = !envvar.isNull();
-		return true;
-	} else if (match_expression.captured(idx_total) == expression) {
+		check.is_expression = true;
+		check.evaluation_success = !envvar.isNull();
+		return check;
+	}
+	const QRegularExpressionMatch match_expression( (needs_prefix? rex_prefixed_expression :
+	    rex_plain_expression).match(expression) );
+	if (match_expression.captured(idx_total) == expression) {
 		/* check if arithmetic expression is valid */
 		QString sub_expr( match_expression.captured(idx_check) );
 		expr::doMetaSubstitutions(substitutions, sub_expr);
-		int status_code;
-		te_interp(sub_expr.toStdString().c_str(), &status_code);
-		evaluation_success = (status_code == 0);
+		check.is_expression = true;
+		if (compiled != nullptr) {
+			check.evaluation_success = compiled->compile(sub_expr);
+			check.ini_keys = compiled->getReferencedKeys();
+			//placeholders that are substituted only for the check can not be evaluated:
+			check.is_compiled = check.evaluation_success && sub_expr == match_expression.captured(idx_check);
+		} else { //only check the syntax
+			const QString bound_expr( bindReferences(sub_expr, check.ini_keys) );
+			const std::vector<double> values( static_cast<size_t>(check.ini_keys.size()) + 1 );
+			te_expr *tree = compileTree(bound_expr, check.ini_keys.size(), values.data());
+			check.evaluation_success = (tree != nullptr);
+			te_free(tree);
+		}
+		return check;
+	}
+	const QRegularExpressionMatch match_inikey( rex_inikey.match(expression) );
+	if (match_inikey.captured(idx_total) == expression) {
+		check.is_expression = true;
+		check.evaluation_success = true; //if the key exists
+		check.ini_keys.push_back(match_inikey.captured(idx_check).trimmed().toLower());
+		return check;
+	}
+	const QRegularExpressionMatch match_scientific( rex_scientific.match(expression) );
+	if (match_scientific.captured(idx_total) == expression) {
+		check.is_expression = true;
+		check.evaluation_success = true;
+	}
+	return check;
+}
+
+/**
+ * @brief Finish an expression check on the GUI thread.
+ * @details If the expression refers to INI keys, check if the keys are in the XML file.
+ * @param[in,out] check The result of parseExpression().
+ */
+void resolveExpression(ExpressionCheck &check)
+{
+	if (!check.evaluation_success)
+		return;
+	for (auto &key : check.ini_keys) { //including environment variables in arithmetic expressions
+		if (!keyExists(key)) {
+			check.evaluation_success = false;
+			return;
+		}
+	}
+}
+
+/**
+ * @class CompiledExpression
+ * @brief Destructor freeing the syntax tree.
+ */
+CompiledExpression::~CompiledExpression()
+{
+	te_free(tree_);
+}
+
+/**
+ * @brief Parse an arithmetic expression.
+ * @details If the expression is the same as the last one, the existing syntax tree is kept.
+ * @param[in] expression The arithmetic expression (without ${{...}}, substitutions already applied).
+ * @return True if the expression is valid.
+ */
+bool CompiledExpression::compile(const QString &expression)
+{
+	if (has_expression_ && expression == expression_)
+		return isCompiled();
+	te_free(tree_);
+	expression_ = expression;
+	has_expression_ = true;
+	keys_.clear();
+	const QString bound_expression( bindReferences(expression, keys_) );
+	values_.reset(new double[static_cast<size_t>(keys_.size()) + 1]()); //the tree points into this
+	tree_ = compileTree(bound_expression, keys_.size(), values_.get());
+	return isCompiled();
+}
+
+/**
+ * @brief Evaluate the compiled expression with the current values of the referenced keys.
+ * @param[out] result The value of the expression.
+ * @param[in] evaluator Looks up (and evaluates) the referenced keys and environment variables.
+ * @param[in] section Section of the key holding the expression, for references without a section.
+ * @return True if the expression could be evaluated (all references evaluate to numbers).
+ */
+bool CompiledExpression::evaluate(double &result, Evaluator &evaluator, const QString &section)
+{
+	if (tree_ == nullptr)
+		return false;
+	for (int ii = 0; ii < keys_.size(); ++ii) {
+		if (!evaluator.evaluateReference(keys_.at(ii), section, values_[static_cast<size_t>(ii)]))
+			return false;
+	}
+	result = te_eval(tree_);
+	return true;
+}
+
+/**
+ * @class Evaluator
+ * @brief Evaluate an INI key's value.
+ * @details The key's raw value is fetched from the value provider and evaluated. The result is
+ * kept, so that every key is evaluated only once no matter how often it is referenced. If the
+ * expression graph has a current value for the key it is taken from there.
+ * @param[in] ini_key The INI key (SECTION::KEY).
+ * @param[out] result The evaluated value.
+ * @return True if the value could be evaluated.
+ */
+bool Evaluator::evaluateKey(const QString &ini_key, QString &result)
+{
+	const QString key( ini_key.toLower() );
+	const auto state_it( states_.constFind(key) );
+	if (state_it != states_.constEnd()) {
+		if (*state_it == KeyState::VISITING) {
+			addDependency(key);
+			errors_.push_back(tr("Circular reference to INI key %1").arg(key));
+			return false;
+		}
+		const EvaluatedValue &evaluated( values_[key] );
+		addDependency(key, evaluated.ini_keys);
+		result = evaluated.value;
+		return (*state_it == KeyState::RESOLVED);
+	}
+	EvaluatedValue cached;
+	if (cache_ != nullptr && cache_->getValue(key, cached)) {
+		states_.insert(key, KeyState::RESOLVED);
+		values_.insert(key, cached);
+		addDependency(key, cached.ini_keys);
+		result = cached.value;
 		return true;
-	} else if (match_inikey.captured(idx_total) == expression) {
-		/* check if INI key is in XML file */
-		const QList<Atomic *> found_panels( getMainWindow()->
-		    getPanelsForKey(match_inikey.captured(idx_check)) );
-		evaluation_success = !found_panels.isEmpty();
+	}
+	addDependency(key); //also if it does not exist - it may appear later
+	QString raw_value;
+	if (!provider_(ini_key, raw_value)) { //the lower case key is only for bookkeeping
+		states_.insert(key, KeyState::FAILED);
+		errors_.push_back(tr("Referenced INI key %1 does not exist").arg(ini_key));
+		return false;
+	}
+	return evaluateValue(raw_value, key, result);
+}
+
+/**
+ * @brief Evaluate a value as if it was set for an INI key.
+ * @details While the value is evaluated, references back to the key are treated as circular.
+ * The result is stored for the key, replacing a previous evaluation.
+ * @param[in] value The value to evaluate.
+ * @param[in] ini_key The INI key (SECTION::KEY) the value belongs to.
+ * @param[out] result The evaluated value. Values that are no expressions are returned as they are.
+ * @param[in] needs_prefix If true, evaluate arithmetic expressions only if ${{...}}.
+ * @return True if the value could be evaluated.
+ */
+bool Evaluator::evaluateValue(const QString &value, const QString &ini_key, QString &result,
+    const bool &needs_prefix)
+{
+	return evaluateFor(ini_key, result, [&](const QString &section, QString &text_result) -> bool {
+		return evaluateText(value, section, text_result, needs_prefix);
+	});
+}
+
+/**
+ * @brief Evaluate an already compiled arithmetic expression as the value of an INI key.
+ * @details This way a panel's syntax tree is reused instead of parsing its expression again.
+ * @param[in] compiled The compiled expression.
+ * @param[in] ini_key The INI key (SECTION::KEY) the expression belongs to.
+ * @param[out] result The value of the expression.
+ * @return True if the expression could be evaluated.
+ */
+bool Evaluator::evaluateCompiled(CompiledExpression &compiled, const QString &ini_key, QString &result)
+{
+	return evaluateFor(ini_key, result, [&](const QString &section, QString &text_result) -> bool {
+		double number;
+		if (!compiled.evaluate(number, *this, section))
+			return false;
+		text_result = QString::number(number, 'g', 15);
+		return true;
+	});
+}
+
+/**
+ * @brief Run an evaluation for an INI key and keep track of its result and dependencies.
+ * @details While the value is evaluated, references back to the key are treated as circular.
+ * Successful results are also stored in the expression graph's cache.
+ * @param[in] ini_key The INI key (SECTION::KEY).
+ * @param[out] result The evaluated value.
+ * @param[in] evaluation Function doing the evaluation.
+ * @return True if the value could be evaluated.
+ */
+bool Evaluator::evaluateFor(const QString &ini_key, QString &result, const TextEvaluation &evaluation)
+{
+	const QString key( ini_key.toLower() );
+	states_.insert(key, KeyState::VISITING);
+	evaluating_.emplace_back(key, QSet<QString>());
+	const bool success = evaluation(key.section(Cst::sep, 0, 0), result);
+	EvaluatedValue evaluated;
+	evaluated.value = result;
+	evaluated.ini_keys = evaluating_.back().second;
+	evaluated.ini_keys.remove(key);
+	evaluating_.pop_back();
+	addDependency(key, evaluated.ini_keys); //for the keys referring to this one
+
+	states_.insert(key, success? KeyState::RESOLVED : KeyState::FAILED);
+	values_.insert(key, evaluated);
+	if (success && cache_ != nullptr)
+		cache_->setValue(key, evaluated);
+	return success;
+}
+
+/**
+ * @brief Note that the keys being evaluated depend on a key.
+ * @param[in] ini_key The referenced key (lower case).
+ * @param[in] indirect_keys The keys the referenced key depends on itself.
+ */
+void Evaluator::addDependency(const QString &ini_key, const QSet<QString> &indirect_keys)
+{
+	for (auto &outer : evaluating_) {
+		outer.second.insert(ini_key);
+		outer.second.unite(indirect_keys);
+	}
+}
+
+/**
+ * @brief Evaluate a reference in an arithmetic expression to a number.
+ * @param[in] reference The reference without ${...}, i. e. an INI key or env:VAR.
+ * @param[in] section Section to look for keys that are given without one.
+ * @param[out] result The referenced value.
+ * @return True if the reference could be evaluated and holds a number.
+ */
+bool Evaluator::evaluateReference(const QString &reference, const QString &section, double &result)
+{
+	QString value;
+	if (isEnvReference(reference)) {
+		const QByteArray envvar( qgetenv(reference.mid(4).toLocal8Bit()) );
+		if (envvar.isNull()) {
+			errors_.push_back(tr("Environment variable %1 is not set").arg(reference.mid(4)));
+			return false;
+		}
+		value = QString::fromLocal8Bit(envvar);
+	} else {
+		const QString key( reference.contains(Cst::sep)? reference : section + Cst::sep + reference );
+		if (!evaluateKey(key, value))
+			return false;
+	}
+	bool is_number;
+	result = value.trimmed().toDouble(&is_number);
+	if (!is_number)
+		errors_.push_back(tr(R"(Reference "%1" in an arithmetic expression is not a number: "%2")").arg(
+		    reference, value));
+	return is_number;
+}
+
+/**
+ * @brief Evaluate a string according to the expression syntax.
+ * @details The same syntax tokens as in parseExpression() are recognized: environment variables,
+ * arithmetic expressions (which may refer to INI keys), and INI keys.
+ * @param[in] text The string to evaluate.
+ * @param[in] section Section to look for referenced keys that are given without one.
+ * @param[out] result The evaluated string.
+ * @param[in] needs_prefix If true, evaluate arithmetic expressions only if ${{...}}.
+ * @return True if the string could be evaluated.
+ */
+bool Evaluator::evaluateText(const QString &text, const QString &section, QString &result,
+    const bool &needs_prefix)
+{
+	static const QRegularExpression rex_envvar(R"(\A\$\{env:([^{}]+)\}\z)");
+	static const QRegularExpression rex_expression(R"(\A\$\{\{(.+)\}\}\z)");
+	static const QRegularExpression rex_inikey(R"(\A\$\{([^{}]+)\}\z)");
+	static const int idx_check = 1;
+
+	const QRegularExpressionMatch match_envvar( rex_envvar.match(text) );
+	if (match_envvar.hasMatch()) {
+		const QByteArray envvar( qgetenv(match_envvar.captured(idx_check).toLocal8Bit()) );
+		if (envvar.isNull()) {
+			errors_.push_back(tr("Environment variable %1 is not set").arg(match_envvar.captured(idx_check)));
+			return false;
+		}
+		result = QString::fromLocal8Bit(envvar);
 		return true;
-	} else if (match_scientific.captured(idx_total) == expression) {
-		evaluation_success = true;
+	}
+	const QRegularExpressionMatch match_expression( rex_expression.match(text) );
+	if (match_expression.hasMatch())
+		return evaluateArithmetic(match_expression.captured(idx_check), section, result);
+	const QRegularExpressionMatch match_inikey( rex_inikey.match(text) );
+	if (match_inikey.hasMatch()) {
+		const QString reference( match_inikey.captured(idx_check).trimmed() );
+		return evaluateKey(reference.contains(Cst::sep)? reference : section + Cst::sep + reference, result);
+	}
+	result = text; //no expression
+	if (!needs_prefix && !text.isEmpty()) { //plain text may be an arithmetic expression
+		QString number;
+		const int error_count = errors_.size();
+		if (evaluateArithmetic(text, section, number))
+			result = number;
+		while (errors_.size() > error_count) //don't report errors for text that is no expression
+			errors_.removeLast();
+	}
+	return true;
+}
+
+/**
+ * @brief Evaluate an arithmetic expression.
+ * @param[in] expression The arithmetic expression without ${{...}}.
+ * @param[in] section Section to look for referenced keys that are given without one.
+ * @param[out] result The value of the expression.
+ * @return True if the expression is valid and all references hold numbers.
+ */
+bool Evaluator::evaluateArithmetic(const QString &expression, const QString &section, QString &result)
+{
+	CompiledExpression compiled;
+	double number;
+	if (!compiled.compile(expression) || !compiled.evaluate(number, *this, section)) {
+		errors_.push_back(tr("Could not evaluate expression %1").arg(expression));
+		return false;
+	}
+	result = QString::number(number, 'g', 15);
+	return true;
+}
+
+/**
+ * @brief Value provider for an evaluator working on the GUI.
+ * @details The value is taken from the panel handling the key, or from the loaded INI file
+ * if there is no panel for it (yet).
+ * @param[in] ini_key The INI key (SECTION::KEY) as it was referenced.
+ * @param[out] value The key's value.
+ * @return True if the key was found.
+ */
+bool getGuiValue(const QString &ini_key, QString &value)
+{
+	for (auto *panel : Atomic::getPanels(ini_key)) {
+		if (qobject_cast<Group *>(panel) != nullptr)
+			continue;
+		QString section, key;
+		value = panel->getIniValue(section, key);
 		return true;
 	}
-	evaluation_success = false;
-	return false;
+	value = getMainWindow()->getIni()->get(ini_key.section(Cst::sep, 0, 0), ini_key.section(Cst::sep, 1));
+	return !value.isNull();
+}
+
+/**
+ * @brief Evaluate a panel's text to display its value.
+ * @param[in] text The panel's text.
+ * @param[in] ini_key The panel's INI key (SECTION::KEY).
+ * @param[out] value The evaluated text.
+ * @details Values of referenced keys are taken from the expression graph's cache as long as they
+ * are current, so only what has changed is evaluated again.
+ * @param[out] ini_keys All keys the value depends on (also through other expressions).
+ * @param[in] needs_prefix If true, evaluate arithmetic expressions only if ${{...}}.
+ * @param[in] compiled If given, this syntax tree of the text's arithmetic expression is evaluated
+ * instead of parsing the text.
+ * @return True if the text is an expression that could be evaluated.
+ */
+bool previewValue(const QString &text, const QString &ini_key, QString &value, QStringList &ini_keys,
+    const bool &needs_prefix, CompiledExpression *compiled)
+{
+	Evaluator evaluator(getGuiValue, &ExpressionGraph::getShared());
+	const bool success = (compiled != nullptr)? evaluator.evaluateCompiled(*compiled, ini_key, value) :
+	    evaluator.evaluateValue(text, ini_key, value, needs_prefix);
+	ini_keys = evaluator.getDependencies(ini_key).values(); //without the panel's own key
+	return success && value != text;
+}
+
+/**
+ * @brief Replace all expressions in an INI file with their values.
+ * @details All keys are evaluated in one pass, referenced keys first. Values that can not be
+ * evaluated (e. g. because of circular references or variables that are only known to the
+ * software reading the INI file) are left as they are.
+ * @param[in,out] ini The INI file to evaluate.
+ * @return Messages for the values that could not be evaluated.
+ */
+QStringList resolveIniExpressions(INIParser &ini)
+{
+	Evaluator evaluator([&ini](const QString &ini_key, QString &value) -> bool { //key in original case
+		value = ini.get(ini_key.section(Cst::sep, 0, 0), ini_key.section(Cst::sep, 1));
+		return !value.isNull();
+	});
+	for (auto &section : *ini.getSections()) {
+		for (auto &keyval : section.getKeyValueList()) { //copy - values are changed in the loop
+			QString resolved;
+			if (evaluator.evaluateKey(section.getName() + Cst::sep + keyval.first, resolved) &&
+			    resolved != keyval.second.getValue())
+				section.getKeyValue(keyval.first)->setValue(resolved);
+		}
+	}
+	return evaluator.getErrors();
+}
+
+/**
+ * @class ExpressionGraph
+ * @brief Get the dependency graph all panels share.
+ * @return The shared expression graph (created on first use).
+ */
+ExpressionGraph & ExpressionGraph::getShared()
+{
+	static ExpressionGraph *graph( new ExpressionGraph(qApp) ); //deleted with the application
+	return *graph;
+}
+
+/**
+ * @brief Constructor for the expression graph.
+ * @param[in] parent The parent object.
+ */
+ExpressionGraph::ExpressionGraph(QObject *parent) : QObject(parent)
+{
+	change_timer_.setSingleShot(true);
+	change_timer_.setInterval(0);
+	connect(&change_timer_, &QTimer::timeout, this, &ExpressionGraph::onChange);
+}
+
+/**
+ * @brief Set the INI keys an object's expression refers to.
+ * @details Previous dependencies of the object are replaced.
+ * @param[in] dependent The object holding the expression (usually a panel).
+ * @param[in] ini_keys The referenced INI keys (lower case). If empty, the object is removed.
+ * @param[in] on_change Function to check the expression again. Only called while the object exists.
+ */
+void ExpressionGraph::setDependencies(QObject *dependent, const QStringList &ini_keys,
+    std::function<void()> on_change)
+{
+	removeDependent(dependent);
+	if (ini_keys.isEmpty())
+		return;
+	Node node;
+	node.dependent = dependent;
+	node.ini_keys = ini_keys;
+	node.on_change = std::move(on_change);
+	for (auto &key : ini_keys)
+		dependents_[key].insert(dependent);
+	nodes_.insert(dependent, node);
+}
+
+/**
+ * @brief Remove all dependencies of an object.
+ * @param[in] dependent The object holding an expression.
+ */
+void ExpressionGraph::removeDependent(QObject *dependent)
+{
+	const auto it( nodes_.find(dependent) );
+	if (it == nodes_.end())
+		return;
+	for (auto &key : it->ini_keys) {
+		const auto dep_it( dependents_.find(key) );
+		if (dep_it == dependents_.end())
+			continue;
+		dep_it->remove(dependent);
+		if (dep_it->isEmpty())
+			dependents_.erase(dep_it);
+	}
+	nodes_.erase(it);
+	pending_.remove(dependent);
+}
+
+/**
+ * @brief Notify the graph that an INI key has changed.
+ * @details The expressions depending on the key are checked again when control returns
+ * to the event loop.
+ * @param[in] ini_key The INI key (lower case).
+ */
+void ExpressionGraph::keyChanged(const QString &ini_key)
+{
+	values_.remove(ini_key); //evaluated values depending on the key are outdated
+	for (auto &dependent_key : value_dependents_.take(ini_key))
+		values_.remove(dependent_key);
+	const auto it( dependents_.constFind(ini_key) );
+	if (it == dependents_.constEnd())
+		return;
+	pending_.unite(*it);
+	if (!change_timer_.isActive())
+		change_timer_.start();
+}
+
+/**
+ * @brief Get the cached evaluated value of an INI key.
+ * @param[in] ini_key The INI key (lower case).
+ * @param[out] value The evaluated value and the keys it depends on.
+ * @return True if a current value is cached.
+ */
+bool ExpressionGraph::getValue(const QString &ini_key, EvaluatedValue &value) const
+{
+	const auto it( values_.constFind(ini_key) );
+	if (it == values_.constEnd())
+		return false;
+	value = *it;
+	return true;
+}
+
+/**
+ * @brief Cache the evaluated value of an INI key.
+ * @details The value is dropped as soon as the key or one of the keys it depends on changes.
+ * @param[in] ini_key The INI key (lower case).
+ * @param[in] value The evaluated value and all keys it depends on.
+ */
+void ExpressionGraph::setValue(const QString &ini_key, const EvaluatedValue &value)
+{
+	values_.insert(ini_key, value);
+	for (auto &key : value.ini_keys)
+		value_dependents_[key].insert(ini_key);
+}
+
+/**
+ * @brief Drop all cached values, e. g. because a new INI file was loaded.
+ */
+void ExpressionGraph::clearValues()
+{
+	values_.clear();
+	value_dependents_.clear();
+}
+
+/**
+ * @brief Check all expressions again whose keys have changed.
+ */
+void ExpressionGraph::onChange()
+{
+	const QSet<QObject *> pending( pending_ );
+	pending_.clear();
+	for (auto *dependent : pending) {
+		const auto it( nodes_.constFind(dependent) );
+		if (it == nodes_.constEnd())
+			continue;
+		if (it->dependent.isNull()) { //deleted without saying goodbye
+			removeDependent(dependent);
+			continue;
+		}
+		const std::function<void()> on_change( it->on_change ); //may change the dependencies
+		on_change();
+	}
 }
 
 /**
@@ -127,8 +749,21 @@ std::vector< std::pair<QString, QString> > parseSubstitutions(const QDomNode &op
  */
 void doMetaSubstitutions(const std::vector<std::pair<QString, QString> > &substitutions, QString &expression)
 {
-	for (auto &sub : substitutions)
-		expression.replace(QRegularExpression(sub.first), sub.second);
+	static QHash<QString, QRegularExpression> regex_cache; //compiled once for all panels
+	static QMutex cache_mutex; //expressions may be checked on worker threads
+	for (auto &sub : substitutions) {
+		QRegularExpression rex;
+		{
+			QMutexLocker lock(&cache_mutex);
+			auto it( regex_cache.find(sub.first) );
+			if (it == regex_cache.end()) {
+				it = regex_cache.insert(sub.first, QRegularExpression(sub.first));
+				it->optimize();
+			}
+			rex = *it;
+		}
+		expression.replace(rex, sub.second);
+	}
 }
 
 
@@ -25,16 +25,171 @@
 #ifndef EXPRESSIONS_H
 #define EXPRESSIONS_H
 
+#include <QCoreApplication> //for translations
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QSet>
 #include <QString>
+#include <QStringList>
+#include <QTimer>
 #include <QtXml>
 
+#include <functional>
+#include <memory>
 #include <vector>
 #include <utility>
 
+struct te_expr; //tinyexpr syntax tree
+class INIParser;
+
 namespace expr {
 
+class Evaluator;
+class ExpressionGraph;
+
+/**
+ * @struct ExpressionCheck
+ * @brief Result of checking the syntax of an expression.
+ */
+struct ExpressionCheck {
+	bool is_expression = false; //the syntax indicates an expression
+	bool is_compiled = false; //the arithmetic expression as entered is in the given CompiledExpression
+	bool evaluation_success = false;
+	QStringList ini_keys; //referenced INI keys (lower case), have to be looked up on the GUI thread
+};
+
+/**
+ * @class CompiledExpression
+ * @brief An arithmetic expression that is parsed only once.
+ * @details References to INI keys (${SECTION::KEY}) in the expression are bound to variables, so
+ * that it can be evaluated with new key values without parsing it again.
+ */
+class CompiledExpression {
+	public:
+		CompiledExpression() = default;
+		~CompiledExpression();
+		CompiledExpression(const CompiledExpression&) = delete;
+		CompiledExpression& operator =(CompiledExpression const&) = delete;
+		CompiledExpression(CompiledExpression&&) = delete;
+		CompiledExpression& operator=(CompiledExpression&&) = delete;
+		bool compile(const QString &expression);
+		bool isCompiled() const noexcept { return tree_ != nullptr; }
+		const QStringList & getReferencedKeys() const noexcept { return keys_; }
+		bool evaluate(double &result, Evaluator &evaluator, const QString &section);
+
+	private:
+		QString expression_; //the syntax tree was compiled from this
+		bool has_expression_ = false;
+		te_expr *tree_ = nullptr;
+		QStringList keys_; //referenced INI keys (lower case), bound to variables in this order
+		std::unique_ptr<double[]> values_; //current values of the referenced keys, read by the tree
+};
+
+/**
+ * @struct EvaluatedValue
+ * @brief The value of an INI key after evaluating its expression.
+ */
+struct EvaluatedValue {
+	QString value;
+	QSet<QString> ini_keys; //all keys the value depends on (also through other expressions)
+};
+
+/**
+ * @class Evaluator
+ * @brief Evaluates INI values holding expressions to plain values.
+ * @details Referenced keys are evaluated before the keys referring to them (depth first, i. e. in
+ * topological order), and each key is evaluated only once per evaluator. Circular references
+ * are detected and reported. With an expression graph, values are reused from the graph's cache
+ * until a key they depend on changes.
+ */
+class Evaluator {
+	Q_DECLARE_TR_FUNCTIONS(Evaluator) //make shortcut tr(...) available
+
+	public:
+		using ValueProvider = std::function<bool(const QString &ini_key, QString &value)>; //raw value of a key (any case)
+		explicit Evaluator(ValueProvider provider, ExpressionGraph *cache = nullptr) :
+		    provider_(std::move(provider)), cache_(cache) {}
+		bool evaluateKey(const QString &ini_key, QString &result);
+		bool evaluateValue(const QString &value, const QString &ini_key, QString &result,
+		    const bool &needs_prefix = true);
+		bool evaluateCompiled(CompiledExpression &compiled, const QString &ini_key, QString &result);
+		bool evaluateReference(const QString &reference, const QString &section, double &result);
+		const QStringList & getErrors() const noexcept { return errors_; }
+		QSet<QString> getDependencies(const QString &ini_key) const { return values_.value(ini_key.toLower()).ini_keys; }
+
+	private:
+		enum class KeyState {
+			VISITING, //being evaluated - meeting it again means a circular reference
+			RESOLVED,
+			FAILED
+		};
+		using TextEvaluation = std::function<bool(const QString &section, QString &result)>;
+		bool evaluateFor(const QString &ini_key, QString &result, const TextEvaluation &evaluation);
+		bool evaluateText(const QString &text, const QString &section, QString &result,
+		    const bool &needs_prefix);
+		bool evaluateArithmetic(const QString &expression, const QString &section, QString &result);
+		void addDependency(const QString &ini_key, const QSet<QString> &indirect_keys = QSet<QString>());
+
+		ValueProvider provider_;
+		ExpressionGraph *cache_ = nullptr; //keeps evaluated values between evaluations
+		QHash<QString, KeyState> states_; //INI key (lower case) -> evaluation state
+		QHash<QString, EvaluatedValue> values_; //INI key (lower case) -> evaluated value (also if it failed)
+		std::vector<std::pair<QString, QSet<QString>>> evaluating_; //keys being evaluated and their dependencies
+		QStringList errors_;
+};
+
+/**
+ * @class ExpressionGraph
+ * @brief Keeps track of the INI keys that the panels' expressions depend on.
+ * @details When a key changes its value (or a panel for it appears or disappears), only the
+ * expressions referring to it are checked again. The checks are collected and run once per
+ * event loop turn.
+ */
+class ExpressionGraph : public QObject {
+	Q_OBJECT
+
+	public:
+		static ExpressionGraph & getShared();
+		void setDependencies(QObject *dependent, const QStringList &ini_keys, std::function<void()> on_change);
+		void removeDependent(QObject *dependent);
+		void keyChanged(const QString &ini_key);
+		bool getValue(const QString &ini_key, EvaluatedValue &value) const;
+		void setValue(const QString &ini_key, const EvaluatedValue &value);
+		void clearValues();
+
+	private:
+		/**
+		 * @struct Node
+		 * @brief An expression that depends on INI keys.
+		 */
+		struct Node {
+			QPointer<QObject> dependent;
+			QStringList ini_keys;
+			std::function<void()> on_change; //re-evaluates the expression
+		};
+
+		explicit ExpressionGraph(QObject *parent = nullptr);
+		void onChange();
+
+		QHash<QObject *, Node> nodes_;
+		QHash<QString, QSet<QObject *>> dependents_; //INI key -> objects whose expressions refer to it
+		QSet<QObject *> pending_; //expressions to check again
+		QHash<QString, EvaluatedValue> values_; //INI key -> evaluated value, until a dependency changes
+		QHash<QString, QSet<QString>> value_dependents_; //INI key -> cached values depending on it
+		QTimer change_timer_;
+};
+
+ExpressionCheck parseExpression(const QString &expression,
+    const std::vector< std::pair<QString, QString> > &substitutions, const bool &needs_prefix = true,
+    CompiledExpression *compiled = nullptr);
+void resolveExpression(ExpressionCheck &check);
 bool checkExpression(const QString &expression, bool &evaluation_success,
     const std::vector< std::pair<QString, QString> > &substitutions, const bool &needs_prefix = true);
+bool getGuiValue(const QString &ini_key, QString &value);
+bool previewValue(const QString &text, const QString &ini_key, QString &value, QStringList &ini_keys,
+    const bool &needs_prefix = true, CompiledExpression *compiled = nullptr);
+QStringList resolveIniExpressions(INIParser &ini);
 std::vector< std::pair<QString, QString> > parseSubstitutions(const QDomNode &options);
 void doMetaSubstitutions(const std::vector< std::pair<QString, QString> > &substitutions, QString &expression);
 
@@ -24,41 +24,6 @@
 	#include <iostream>
 #endif
 
-/**
- * @class PropertyWatcher
- * @brief This class listens to changes of the INI value from anywhere in the program.
- * @details INIshell uses Qt's property system to tell a panel that the INI value has
- * been modified. When the PropertyWatcher detects a change in the "ini_value" property,
- * the changedValue() signal is emitted to Atomic, which in turn delegates the signal
- * to the specific panel's onPropertySet() function.
- * This is used for changes in the INI value from "outside" to tell the panel that it
- * should modify the displayed value. Hence, it is not used when a value is changed
- * through user interaction (because it is already being displayed).
- * @param parent The object's parent.
- */
-PropertyWatcher::PropertyWatcher(QObject *parent) : QObject(parent)
-{
-	//do nothing
-}
-
-/**
- * @brief Event filter of the PropertyWatcher.
- * @details This PropertyWatcher only listens to changes in the "ini_value" property.
- * @param[in] object The object for which an event has occurred.
- * @param[in] event The event that has occurred.
- * @return True if the event is being accepted.
- */
-bool PropertyWatcher::eventFilter(QObject *object, QEvent *event) {
-	//only act on changes to the "ini_value" property:
-	if(event->type() == QEvent::DynamicPropertyChange) {
-		auto *const propEvent = static_cast<QDynamicPropertyChangeEvent *>(event);
-		const QString property_name(propEvent->propertyName().data());
-		if (property_name == "ini_value")
-			emit changedValue(); //changedValue will be connected to a function in Atomic
-	}
-	return QObject::eventFilter(object, event);
-}
-
 /**
  * @brief Retrieve a pointer to the main window for member access etc.
  * @return Pointer to the main window.
@@ -88,15 +53,17 @@ MainWindow * getMainWindow()
  * @param[in] parent_group The Group to build in. If empty, it will be created in the main tab.
  * @param[in] parent_section The current section. If omitted, the parent section is chosen.
  * @param[in] no_spacers The parent group requests to save space and build a tight layout.
+ * @param[in] defer_tabs At the top level, only create the tabs and leave building their contents
+ * to when they are first needed (cf. ScrollPanel::buildPendingNodes()).
  */
-void recursiveBuild(const QDomNode &parent_node, Group *parent_group, const QString &parent_section, const bool &no_spacers)
+void recursiveBuild(const QDomNode &parent_node, Group *parent_group, const QString &parent_section,
+    const bool &no_spacers, const bool &defer_tabs)
 {
 	/* run through all child nodes of the current level */
 	for (QDomNode current_node = parent_node.firstChildElement(); !current_node.isNull(); current_node = current_node.nextSibling()) {
 
 		/* read some attributes */
 		QDomElement current_element( current_node.toElement() );
-		const QString key( current_element.attribute("key") ); //INI key
 		const QString element_type( current_element.tagName() ); //identifier for the node's purpose
 		//from here we build frames and parameter panels; everything else (e. g. options) is done elsewhere:
 		if (element_type != "frame" && element_type != "parameter" && element_type != "section")
@@ -104,7 +71,8 @@ void recursiveBuild(const QDomNode &parent_node, Group *parent_group, const QStr
 
 		/* read requested section from a number of different places in the XML */
 		if (parent_group == nullptr && element_type == "section") { //dedicated <section> node
-			recursiveBuild(current_node, parent_group, current_node.toElement().attribute("name"));
+			recursiveBuild(current_node, parent_group, current_node.toElement().attribute("name"),
+			    false, defer_tabs);
 			continue;
 		}
 		QStringList section_list;
@@ -126,34 +94,54 @@ void recursiveBuild(const QDomNode &parent_node, Group *parent_group, const QStr
 					if (tab_font_color.isEmpty())
 					tab_font_color = parent_node.toElement().attribute("color");
 				}
-				group_to_add_to = getMainWindow()->getControlPanel()->
-				    getSectionScrollarea(current_section, tab_background_color, tab_font_color)->getGroup();
-			}
-			if (element_type == "frame") { //visual grouping by a frame with title
-				const QString frame_title(current_element.attribute("caption"));
-				const QString frame_color(current_element.attribute("color"));
-				const QString frame_background_color(current_element.attribute("background_color"));
-				/* construct new group with border and title for the frame */
-				Group *frame = new Group(current_section, key, true, false, true, false,
-				    frame_title, frame_color, frame_background_color);
-				group_to_add_to->addWidget(frame);
-				recursiveBuild(current_node, frame, current_section); //all children go into the frame
-			} else if (element_type == "parameter") { //a panel
-				if (current_element.attribute("template").toLower() == "true") //Selector panel will handle this
+				ScrollPanel *tab_scroll( getMainWindow()->getControlPanel()->
+				    getSectionScrollarea(current_section, tab_background_color, tab_font_color) );
+				if (defer_tabs) { //build when the tab is shown or receives INI values
+					tab_scroll->addPendingNode(current_node, current_section);
 					continue;
-				/* build the desired object, add it to the parent group, and recursively build its children */
-				QWidget *new_element = elementFactory(current_element.attribute("type"), current_section, key,
-				    current_node, no_spacers);
-				if (new_element != nullptr) {
-					group_to_add_to->addWidget(new_element);
-					recursiveBuild(current_node, group_to_add_to, current_section, no_spacers);
 				}
-			} //endif element type
+				group_to_add_to = tab_scroll->getGroup();
+			}
+			buildElement(current_node, group_to_add_to, current_section, no_spacers);
 		} //endfor section_list
 		//TODO: respect multiple colors if multiple sections are given
 	} //endfor current_node
 }
 
+/**
+ * @brief Build a single frame or panel (with its children) into a group.
+ * @param[in] node The XML node of the frame or panel.
+ * @param[in] group The Group to build in.
+ * @param[in] section The section the frame or panel is built for.
+ * @param[in] no_spacers The parent group requests to save space and build a tight layout.
+ */
+void buildElement(const QDomNode &node, Group *group, const QString &section, const bool &no_spacers)
+{
+	const QDomElement element( node.toElement() );
+	const QString key( element.attribute("key") ); //INI key
+	const QString element_type( element.tagName() );
+	if (element_type == "frame") { //visual grouping by a frame with title
+		const QString frame_title(element.attribute("caption"));
+		const QString frame_color(element.attribute("color"));
+		const QString frame_background_color(element.attribute("background_color"));
+		/* construct new group with border and title for the frame */
+		Group *frame = new Group(section, key, true, false, true, false,
+		    frame_title, frame_color, frame_background_color);
+		group->addWidget(frame);
+		recursiveBuild(node, frame, section); //all children go into the frame
+	} else if (element_type == "parameter") { //a panel
+		if (element.attribute("template").toLower() == "true") //Selector panel will handle this
+			return;
+		/* build the desired object, add it to the parent group, and recursively build its children */
+		QWidget *new_element = elementFactory(element.attribute("type"), section, key,
+		    node, no_spacers);
+		if (new_element != nullptr) {
+			group->addWidget(new_element);
+			recursiveBuild(node, group, section, no_spacers);
+		}
+	} //endif element type
+}
+
 /**
  * @brief Helper function to retrieve the section(s) that were set via XML.
  * @details They can be set via a parent <section> node (handled outside), <section>
@@ -36,23 +36,10 @@
 #include <QWidgetList>
 #include <QtXml>
 
-class PropertyWatcher : public QObject
-{
-	Q_OBJECT
-
-	public:
-		PropertyWatcher(QObject *parent);
-
-	signals:
-		void changedValue();
-
-	protected:
-		bool eventFilter(QObject *obj, QEvent *event) override;
-};
-
 MainWindow* getMainWindow();
 void recursiveBuild(const QDomNode &parent_node, Group *parent_group, const QString &parent_section,
-    const bool& no_spacers = false);
+    const bool& no_spacers = false, const bool &defer_tabs = false);
+void buildElement(const QDomNode &node, Group *group, const QString &section, const bool &no_spacers = false);
 bool parseAvailableSections(const QDomElement &current_element, const QString &parent_section, QStringList &section_list);
 void topLog(const QString &message, const QString &color = "normal");
 void topStatus(const QString &message, const QString &color = "normal", const bool &status_light = false,
@@ -212,12 +212,23 @@ void setAppStylesheet(QApplication &app, const command_line_args &cmd_args)
 	 * expressions, ...).
 	 * We also try to avoid gaps and borders of different colors, hence we set backgrounds for some
 	 * of our design elements trying to take into account current OS color scheme settings.
+	 * The panels' looks are set here via properties as well, so that creating a panel does not
+	 * require parsing a stylesheet of its own (e. g. the "group_style" of a Group, or text that
+	 * is hidden by coloring it like the background).
 	 */
 	app.setStyleSheet(" \
 	    * [mandatory=\"true\"] {background-color: " + colors::getQColor("mandatory").name() + "; color: " + colors::getQColor("normal").name() + "} \
 	    * [shows_default=\"true\"] {font-style: italic; color: " + colors::getQColor("default_values").name() + "} \
 	    * [faulty=\"true\"] {color: " + colors::getQColor("faulty_values").name() + "} \
 	    * [valid=\"true\"] {color: " + colors::getQColor("valid_values").name() + "} \
+	    * [empty=\"true\"] {color: " + colors::getQColor("app_bg").name() + "} \
+	    * [empty=\"true\"][mandatory=\"true\"] {color: " + colors::getQColor("mandatory").name() + "} \
+	    QGroupBox[group_style=\"plain\"] {border: none; margin-top: 0px} \
+	    QGroupBox[group_style=\"border\"] {border: 1px solid " + colors::getQColor("groupborder").name() + "; border-radius: 6px} \
+	    QGroupBox[group_style=\"frame\"] {border: 2px solid " + colors::getQColor("frameborder").name() + "; border-radius: 6px; margin-top: 8px; color: " + colors::getQColor("frameborder").name() + "} \
+	    QGroupBox[group_style=\"frame\"]::title {subcontrol-origin: margin; left: 17px; padding: 0px 5px 0px 5px} \
+	    QGroupBox[group_style=\"frame\"][flash=\"true\"] {border-color: " + colors::getQColor("important").name() + "; color: " + colors::getQColor("important").name() + "} \
+	    QToolButton[expression_switch=\"true\"]:checked {background-color: " + colors::getQColor("number").name() + "} \
 	    QTabWidget {padding: 0px; font-weight: bold; background-color: " + colors::getQColor("app_bg").name() + "} \
 	    QTabWidget:pane {background-color: " + colors::getQColor("app_bg").name() + "} \
 	    QScrollArea {background-color: " + colors::getQColor("app_bg").name() + "} \
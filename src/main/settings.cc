@@ -17,6 +17,7 @@
 */
 
 #include "settings.h"
+#include "src/main/colors.h"
 #include "src/main/constants.h"
 #include "src/main/Error.h"
 #include "src/main/inishell.h"
@@ -25,8 +26,16 @@
 #include <QApplication>
 #include <QCoreApplication>
 #include <QDir>
+#include <QHash>
+#include <QSaveFile>
+#include <QSet>
 
 QDomDocument global_xml_settings = QDomDocument( ); //the settings are always in scope
+static QHash<QString, QString> settings_registry; //"setting::name@attribute" -> value
+static QSet<QString> pending_settings; //registry keys that are not written to the XML yet
+using ListEntries = QList<QPair<QString, QString>>; //key attribute and text of each list node
+static QHash<QString, ListEntries> list_registry; //"setting::name@attribute" of the list nodes -> entries
+static QSet<QString> pending_lists; //list registry keys that are not written to the XML yet
 
 /*
  * To add a new user setting you only need to incorporate it into the settings_dialog.xml.
@@ -34,9 +43,178 @@ QDomDocument global_xml_settings = QDomDocument( ); //the settings are always in
  * as well. New settings that are not displayed to the user you can just start using right away.
  */
 
+/**
+ * @class SettingsNotifier
+ * @brief Tells interested parts of the program about changed settings, and writes the
+ * settings file shortly after changes were made.
+ * @param[in] parent The object's parent.
+ */
+SettingsNotifier::SettingsNotifier(QObject *parent) : QObject(parent)
+{
+	save_timer_.setSingleShot(true);
+	save_timer_.setInterval(Cst::settings_save_delay);
+	connect(&save_timer_, &QTimer::timeout, []() { saveSettings(); });
+}
+
+/**
+ * @brief Retrieve the notifier that all settings changes go through.
+ * @return The shared SettingsNotifier (created on first use).
+ */
+SettingsNotifier * SettingsNotifier::getShared()
+{
+	static SettingsNotifier *notifier( new SettingsNotifier(qApp) ); //deleted with the application
+	return notifier;
+}
+
+/**
+ * @brief Write the settings file after a short while.
+ * @details Each change restarts the timer, so that the file is written once no further changes
+ * have been made for a while.
+ */
+void SettingsNotifier::scheduleSave()
+{
+	save_timer_.start(); //restarts a running timer
+}
+
+/**
+ * @brief Build the key of a setting in the in-memory registry.
+ * @param[in] setting_name The setting in the format "section::subsection::...::key".
+ * @param[in] attribute The XML attribute, or a Null-string for the node's text.
+ * @return Key for the settings registry.
+ */
+static QString getRegistryKey(const QString &setting_name, const QString &attribute)
+{
+	return setting_name + "@" + attribute;
+}
+
+/**
+ * @brief Enter a settings node with its attributes and children into the registry.
+ * @details Like getSetting() did with the XML nodes, the first node of a name wins.
+ * @param[in] element The settings node.
+ * @param[in] setting_name The node's setting name.
+ */
+static void registerSettingsNode(const QDomElement &element, const QString &setting_name)
+{
+	const QDomNamedNodeMap attributes( element.attributes() );
+	for (int ii = 0; ii < attributes.count(); ++ii) {
+		const QDomAttr attribute( attributes.item(ii).toAttr() );
+		const QString key( getRegistryKey(setting_name, attribute.name()) );
+		if (!settings_registry.contains(key))
+			settings_registry.insert(key, attribute.value());
+	}
+	const QString text_key( getRegistryKey(setting_name, QString()) );
+	if (!settings_registry.contains(text_key))
+		settings_registry.insert(text_key, element.text());
+	for (QDomElement child( element.firstChildElement() ); !child.isNull(); child = child.nextSiblingElement())
+		registerSettingsNode(child, setting_name + "::" + child.tagName());
+}
+
+/**
+ * @brief Read all settings from the settings XML into the in-memory registry.
+ */
+static void loadSettingsRegistry()
+{
+	settings_registry.clear();
+	pending_settings.clear();
+	list_registry.clear(); //lists are read from the XML on first use
+	pending_lists.clear();
+	const QDomElement root( global_xml_settings.firstChildElement() );
+	for (QDomElement child( root.firstChildElement() ); !child.isNull(); child = child.nextSiblingElement())
+		registerSettingsNode(child, child.tagName());
+}
+
+/**
+ * @brief Write a single setting to the settings XML.
+ * @param[in] setting_name The setting in the format "section::subsection::...::key".
+ * @param[in] attribute XML attribute to set for the settings key. If not specified, the settings
+ * key's text is set.
+ * @param[in] value Value to set.
+ */
+static void writeSettingToXml(const QString &setting_name, const QString &attribute, const QString &value)
+{
+	QStringList setting = setting_name.split("::");
+	QDomNode s_node(global_xml_settings.firstChildElement());
+	for (auto &part : setting) { //look for the setting's node, creating the parents if necessary
+		auto check_node = s_node.firstChildElement(part);
+		if (check_node.isNull())
+			s_node = s_node.appendChild(global_xml_settings.createElement(part));
+		else
+			s_node = check_node;
+	}
+	if (attribute.isNull()) { //<setting>value</setting>
+		while (s_node.hasChildNodes())
+			s_node.removeChild(s_node.firstChild());
+		s_node.appendChild(global_xml_settings.createTextNode(value));
+	} else { //<setting attribute="value"/>
+		s_node.toElement().setAttribute(attribute, value);
+	}
+}
+
+/**
+ * @brief Write a list setting to the settings XML.
+ * @details All of the parent's child nodes with the list's name are replaced by the list entries.
+ * @param[in] list_key Key of the list in the list registry.
+ */
+static void writeListToXml(const QString &list_key)
+{
+	const int separator = list_key.lastIndexOf("@");
+	const QString key_attribute( list_key.mid(separator + 1) );
+	const QString list_name( list_key.left(separator) );
+	const int name_separator = list_name.lastIndexOf("::");
+	const QString node_name( list_name.mid(name_separator + 2) );
+
+	QDomNode parent_node(global_xml_settings.firstChildElement());
+	for (auto &part : list_name.left(name_separator).split("::")) { //create the parents if necessary
+		auto check_node = parent_node.firstChildElement(part);
+		if (check_node.isNull())
+			parent_node = parent_node.appendChild(global_xml_settings.createElement(part));
+		else
+			parent_node = check_node;
+	}
+	for (auto node = parent_node.firstChildElement(node_name); !node.isNull();) {
+		const QDomElement next( node.nextSiblingElement(node_name) );
+		parent_node.removeChild(node);
+		node = next;
+	}
+	for (auto &entry : list_registry.value(list_key)) {
+		QDomElement new_node( global_xml_settings.createElement(node_name) );
+		if (!key_attribute.isEmpty())
+			new_node.setAttribute(key_attribute, entry.first);
+		new_node.appendChild(global_xml_settings.createTextNode(entry.second));
+		parent_node.appendChild(new_node);
+	}
+}
+
+/**
+ * @brief Get the entries of a list setting from the registry.
+ * @details The list is read from the settings XML the first time it is used.
+ * @param[in] parent_setting The outer settings name.
+ * @param[in] node_name The inner settings name.
+ * @param[in] key_attribute The attribute to read along with each node's text, if any.
+ * @return The list's entries in the registry.
+ */
+static ListEntries & getListEntries(const QString &parent_setting, const QString &node_name,
+    const QString &key_attribute)
+{
+	const QString list_key( getRegistryKey(parent_setting + "::" + node_name, key_attribute) );
+	auto it( list_registry.find(list_key) );
+	if (it != list_registry.end())
+		return it.value();
+
+	QDomNode parent_node(global_xml_settings.firstChildElement());
+	for (auto &part : parent_setting.split("::"))
+		parent_node = parent_node.firstChildElement(part);
+	ListEntries entries;
+	for (auto node = parent_node.firstChildElement(node_name); !node.isNull();
+	    node = node.nextSiblingElement(node_name))
+		entries.push_back(qMakePair(key_attribute.isEmpty()? QString() : node.attribute(key_attribute),
+		    node.text()));
+	return list_registry.insert(list_key, entries).value();
+}
+
 /**
  * @brief Check if a valid settings file is available, and if not, create it.
- * @param xml_settings
+ * @details Afterwards, the settings are read into memory.
  */
 void checkSettings()
 {
@@ -48,19 +226,35 @@ void checkSettings()
 		global_xml_settings.setContent(settings_minimal); //will be saved on program end
 		resettings.close();
 	}
+	loadSettingsRegistry();
+	colors::invalidateTheme(); //dark mode may be set
 }
 
 /**
  * @brief Save the current settings to the file system.
- * @param[in] xml_settings The temporary XML document that is being manipulated by the program.
+ * @details Settings that have changed in memory are written to the XML document first.
+ * The file is replaced only after it was written completely, so a crash while saving can not
+ * leave a broken settings file behind.
  */
 void saveSettings()
 {
+	SettingsNotifier::getShared()->cancelSave(); //saving now
+	for (auto &key : pending_settings) {
+		const int separator = key.lastIndexOf("@");
+		const QString attribute( key.mid(separator + 1) );
+		writeSettingToXml(key.left(separator), attribute.isEmpty()? QString() : attribute,
+		    settings_registry.value(key));
+	}
+	pending_settings.clear();
+	for (auto &list_key : pending_lists)
+		writeListToXml(list_key);
+	pending_lists.clear();
+
 	const QString settings_file(getMainWindow()->getXmlSettingsFilename());
 	QDir settings_dir;
 	settings_dir.mkpath(QFileInfo( settings_file ).path()); //create settings location if non-existent
 
-	QFile outfile(settings_file);
+	QSaveFile outfile(settings_file);
 	if(!outfile.open(QIODevice::WriteOnly | QIODevice::Text)) {
 		Error(QApplication::tr("Could not open settings file for writing"), QString(),
 		    QDir::toNativeSeparators(settings_file) + ":\n" + outfile.errorString());
@@ -69,7 +263,20 @@ void saveSettings()
 
 	QTextStream out_ss(&outfile);
 	out_ss << global_xml_settings.toString();
-	outfile.close();
+	out_ss.flush();
+	if (!outfile.commit()) { //the previous file is left untouched
+		Error(QApplication::tr("Could not write settings file"), QString(),
+		    QDir::toNativeSeparators(settings_file) + ":\n" + outfile.errorString());
+	}
+}
+
+/**
+ * @brief Tell the settings system that the settings in memory were changed.
+ * @details The settings file will be written shortly after.
+ */
+static void settingsModified()
+{
+	SettingsNotifier::getShared()->scheduleSave();
 }
 
 /**
@@ -85,7 +292,7 @@ QString getSettingsFileName()
 }
 
 /**
- * @brief Read a single setting from the settings XML.
+ * @brief Read a single setting.
  * @param[in] setting_name The setting to read in the format "section::subsection::...::key"
  * @param[in] attribute XML attribute to read from the settings key. If not set, the settings
  * key's text node value is returned.
@@ -93,14 +300,32 @@ QString getSettingsFileName()
  */
 QString getSetting(const QString &setting_name, const QString &attribute)
 {
-	QStringList setting = setting_name.split("::");
-	QDomNode s_node(global_xml_settings.firstChildElement());
-	for (auto &part : setting)
-		s_node = s_node.firstChildElement(part);
-	if (attribute.isNull()) //<setting>value</setting>
-		return s_node.toElement().text();
-	else //<setting attribute="value"/>
-		return s_node.toElement().attribute(attribute);
+	return settings_registry.value(getRegistryKey(setting_name, attribute));
+}
+
+/**
+ * @brief Read a setting that is either "TRUE" or "FALSE".
+ * @param[in] setting_name The setting to read in the format "section::subsection::...::key"
+ * @param[in] attribute XML attribute to read from the settings key.
+ * @return True if the setting is "TRUE".
+ */
+bool getBoolSetting(const QString &setting_name, const QString &attribute)
+{
+	return (getSetting(setting_name, attribute) == "TRUE");
+}
+
+/**
+ * @brief Read a numeric setting.
+ * @param[in] setting_name The setting to read in the format "section::subsection::...::key"
+ * @param[in] attribute XML attribute to read from the settings key.
+ * @param[in] fallback Value to return if the setting is not set or not a number.
+ * @return The setting's value.
+ */
+int getIntSetting(const QString &setting_name, const QString &attribute, const int &fallback)
+{
+	bool success;
+	const int value = getSetting(setting_name, attribute).toInt(&success);
+	return success? value : fallback;
 }
 
 /**
@@ -117,44 +342,72 @@ QString getSetting(const QString &setting_name, const QString &attribute)
  */
 QStringList getListSetting(const QString &parent_setting, const QString &node_name)
 {
-	QStringList setting = parent_setting.split("::");
-	QDomNode parent_node(global_xml_settings.firstChildElement());
-	for (int ii = 0; ii < setting.size(); ++ii)
-		parent_node = parent_node.firstChildElement(setting[ii]);
-
 	QStringList value_list;
-	for (auto node = parent_node.firstChildElement(node_name); !node.isNull();
-	    node = node.nextSiblingElement(node_name)) {
-		value_list.push_back(node.text());
-	} //endfor node
+	for (auto &entry : getListEntries(parent_setting, node_name, QString()))
+		value_list.push_back(entry.second);
 	return value_list;
 }
 
+/**
+ * @brief Get a list of child nodes of a parent setting's node that are told apart by an attribute.
+ * @details For example, this reads the INI files to load automatically for applications:
+ * <autoload>
+ *     <ini application="my_app">my_file.ini</ini>
+ *     ...
+ * </autoload>
+ * @param parent_setting The outer settings name (here: "user::autoload").
+ * @param node_name The inner settings name (here: "ini").
+ * @param key_attribute The attribute telling the nodes apart (here: "application").
+ * @return Pairs of attribute value and node text (here: {("my_app", "my_file.ini"), ...}).
+ */
+QList<QPair<QString, QString>> getKeyedListSetting(const QString &parent_setting, const QString &node_name,
+    const QString &key_attribute)
+{
+	return getListEntries(parent_setting, node_name, key_attribute);
+}
+
 /**
  * @brief Set a list of values as child nodes in a parent setting's node.
- * @details This is the opposite of getListSetting(), removing all items of the parent
- * setting node, and then adding the given list.
+ * @details This is the opposite of getListSetting(), replacing all items of the parent
+ * setting node with the given list. Like setSetting(), the list is changed in memory and written
+ * to the settings file a little later.
  * @param parent_setting The parent setting's name.
  * @param node_name The child setting's name.
  * @param item_list The list of values to set.
  */
 void setListSetting(const QString &parent_setting, const QString &node_name, const QStringList &item_list)
 {
-	QStringList setting = parent_setting.split("::");
-	QDomNode parent_node(global_xml_settings.firstChildElement());
-	for (int ii = 0; ii < setting.size(); ++ii)
-		parent_node = parent_node.firstChildElement(setting[ii]);
-	while (parent_node.hasChildNodes()) //clear the node
-		parent_node.removeChild(parent_node.firstChild());
-
-	for (auto &item : item_list) {
-		QDomNode new_node = parent_node.appendChild(global_xml_settings.createElement(node_name));
-		new_node.appendChild(global_xml_settings.createTextNode(item));
-	}
+	ListEntries entries;
+	for (auto &item : item_list)
+		entries.push_back(qMakePair(QString(), item));
+	setKeyedListSetting(parent_setting, node_name, QString(), entries);
+	settings_registry.insert(getRegistryKey(parent_setting + "::" + node_name, QString()),
+	    item_list.isEmpty()? QString() : item_list.first()); //getSetting() finds the first node
+}
+
+/**
+ * @brief Set a list of child nodes that are told apart by an attribute.
+ * @details This is the opposite of getKeyedListSetting().
+ * @param parent_setting The parent setting's name.
+ * @param node_name The child setting's name.
+ * @param key_attribute The attribute telling the nodes apart.
+ * @param items Pairs of attribute value and node text to set.
+ */
+void setKeyedListSetting(const QString &parent_setting, const QString &node_name,
+    const QString &key_attribute, const QList<QPair<QString, QString>> &items)
+{
+	ListEntries &entries( getListEntries(parent_setting, node_name, key_attribute) );
+	if (entries == items)
+		return;
+	entries = items;
+	pending_lists.insert(getRegistryKey(parent_setting + "::" + node_name, key_attribute));
+	settingsModified();
 }
 
 /**
- * @brief Set a single setting in the XML settings.
+ * @brief Set a single setting.
+ * @details The setting is changed in memory and written to the settings file a little later
+ * (or when the program ends).
  * @param[in] setting_name The setting to read in the format "section::subsection::...::key"
  * @param[in] attribute XML attribute to set for the settings key. If not specified, the settings
  * key's text node value is altered.
@@ -162,19 +415,14 @@ void setListSetting(const QString &parent_setting, const QString &node_name, con
  */
 void setSetting(const QString &setting_name, const QString &attribute, const QString &value)
 {
-	QStringList setting = setting_name.split("::");
-	QDomNode s_node(global_xml_settings.firstChildElement());
-	for (auto &part : setting) { //look for the setting's node, creating the parents if necessary
-		auto check_node = s_node.firstChildElement(part);
-		if (check_node.isNull())
-			s_node = s_node.appendChild(global_xml_settings.createElement(part));
-		else
-			s_node = check_node;
-	}
-	if (attribute.isNull()) //<setting>value</setting>
-		s_node.setNodeValue(value);
-	else //<setting attribute="value"/>
-		s_node.toElement().setAttribute(attribute, value);
+	const QString key( getRegistryKey(setting_name, attribute) );
+	const auto it( settings_registry.constFind(key) );
+	if (it != settings_registry.constEnd() && it.value() == value)
+		return;
+	settings_registry.insert(key, value);
+	pending_settings.insert(key);
+	emit SettingsNotifier::getShared()->settingChanged(setting_name, attribute, value);
+	settingsModified();
 }
 
 /**
@@ -18,6 +18,8 @@
 
 /*
  * XML interfact to manage INIshell's settings for the static part of the GUI.
+ * The settings are read from the XML once and kept in memory, changes are written back
+ * to the file shortly after they were made.
  * The Settings page itself is handled by MainPanel.cc
  * 2019-10
  */
@@ -26,10 +28,14 @@
 #define SETTINGS_H
 
 #include <QButtonGroup>
+#include <QList>
 #include <QListWidget>
+#include <QPair>
+#include <QObject>
 #include <QStackedWidget>
 #include <QString>
 #include <QStringList>
+#include <QTimer>
 #include <QWidget>
 #include <QtXml>
 
@@ -47,14 +53,37 @@ struct command_line_args {
 		QString program_style = "";
 };
 
+class SettingsNotifier : public QObject {
+	Q_OBJECT
+
+	public:
+		static SettingsNotifier * getShared();
+		void scheduleSave();
+		void cancelSave() { save_timer_.stop(); }
+
+	signals:
+		void settingChanged(const QString &setting_name, const QString &attribute, const QString &value);
+
+	private:
+		explicit SettingsNotifier(QObject *parent = nullptr);
+
+		QTimer save_timer_; //collects changes before writing the file
+};
+
 void groupButtons(QButtonGroup &group, QWidget *parent);
 void checkSettings();
 void saveSettings();
 
 QString getSettingsFileName();
 QString getSetting(const QString &setting_name, const QString &attribute = QString());
+bool getBoolSetting(const QString &setting_name, const QString &attribute = "value");
+int getIntSetting(const QString &setting_name, const QString &attribute = "value", const int &fallback = 0);
 QStringList getListSetting(const QString &parent_setting, const QString &node_name = QString());
 void setListSetting(const QString &parent_setting, const QString &node_name, const QStringList &item_list);
+QList<QPair<QString, QString>> getKeyedListSetting(const QString &parent_setting, const QString &node_name,
+    const QString &key_attribute);
+void setKeyedListSetting(const QString &parent_setting, const QString &node_name,
+    const QString &key_attribute, const QList<QPair<QString, QString>> &items);
 void setSetting(const QString &setting_name, const QString &attribute = QString(),
     const QString &value = QString());
 QStringList getSimpleSettingsNames();